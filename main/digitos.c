@@ -26,6 +26,8 @@ SPDX-License-Identifier: MIT
 #include "digitos.h"
 #include "ili9341.h"
 #include <stddef.h>
+#include <string.h>
+#include <assert.h>
 
 /* === Macros definitions ========================================================================================== */
 
@@ -37,27 +39,80 @@ SPDX-License-Identifier: MIT
 #define SEGMENTO_F 0x20 //!< Máscara para el segmento F
 #define SEGMENTO_G 0x40 //!< Máscara para el segmento G
 
+#define SEGMENTO_G1 0x0040 //!< Máscara para la mitad izquierda del segmento central de los paneles de texto
+#define SEGMENTO_G2 0x0080 //!< Máscara para la mitad derecha del segmento central de los paneles de texto
+#define SEGMENTO_H  0x0100 //!< Máscara para la diagonal superior izquierda de los paneles de texto
+#define SEGMENTO_I  0x0200 //!< Máscara para el segmento vertical superior central de los paneles de texto
+#define SEGMENTO_J  0x0400 //!< Máscara para la diagonal superior derecha de los paneles de texto
+#define SEGMENTO_K  0x0800 //!< Máscara para la diagonal inferior izquierda de los paneles de texto
+#define SEGMENTO_L  0x1000 //!< Máscara para el segmento vertical inferior central de los paneles de texto
+#define SEGMENTO_M  0x2000 //!< Máscara para la diagonal inferior derecha de los paneles de texto
+
+#define DIGITO_SIN_DIBUJAR 0xFF //!< Valor de un digito cuya celda no fue dibujada o fue borrada
+#define CANTIDAD_CARACTERES 17  //!< Cantidad de caracteres de la tabla DIGITOS
+#define CARACTER_APAGADO    16  //!< Caracter de la tabla DIGITOS con todos los segmentos apagados
+#define PRIMERA_LETRA       ' ' //!< Código del primer caracter de la tabla LETRAS
+#define CANTIDAD_LETRAS     64  //!< Cantidad de caracteres de la tabla LETRAS, del espacio al guión bajo
+
+#define SEPARADOR_TIPO      0x03 //!< Máscara del tipo de separador guardado en cada posición
+#define SEPARADOR_APAGADO   0x80 //!< Marca de un separador que se muestra apagado
+
+#define PANEL(indice, generacion) (((uint32_t)(generacion) << 16) | ((indice) + 1)) //!< Referencia a una instancia
+#define PANEL_INDICE(panel)       (((panel)&0xFFFF) - 1)                           //!< Instancia de una referencia
+#define PANEL_GENERACION(panel)   ((uint16_t)((panel) >> 16))                      //!< Generación de una referencia
+#define SIN_INSTANCIAS            0xFF //!< Fin de la lista de instancias libres
+
+#define COLOR_FONDO     0 //!< Indice en las corridas del color de fondo del panel
+#define COLOR_APAGADO   1 //!< Indice en las corridas del color de los segmentos apagados
+#define COLOR_ENCENDIDO 2 //!< Indice en las corridas del color de los segmentos encendidos
+
+#define CORRIDA(color, longitud) (((color) << 14) | (longitud)) //!< Palabra que codifica una corrida de pixeles
+#define CORRIDA_COLOR(corrida)    ((corrida) >> 14)             //!< Indice del color de una corrida
+#define CORRIDA_LONGITUD(corrida) ((corrida)&0x3FFF)            //!< Cantidad de pixeles de una corrida
+
+#define MAXIMO_CORRIDAS_FILA (2 * CANTIDAD_SEGMENTOS + 1) //!< Corridas de una fila que cruza todos los segmentos
+#define COSTO_VENTANA        64 //!< Bytes que se podrian enviar en el tiempo que lleva abrir una ventana en la pantalla
+
 /* === Private data type declarations ============================================================================== */
 
-typedef struct punto_s {
-    uint16_t x;
-    uint16_t y;
-} * punto_t;
-
-typedef struct area_s {
-    struct punto_s desde;
-    struct punto_s hasta;
-} * area_t;
-
-typedef struct segmentos_s {
-    struct area_s a;
-    struct area_s b;
-    struct area_s c;
-    struct area_s d;
-    struct area_s e;
-    struct area_s f;
-    struct area_s g;
-} * segmentos_t;
+typedef struct punto_s * punto_t;
+
+typedef const struct area_s * area_t;
+
+/**
+ * @brief Geometria compartida por todos los paneles de un tamaño de digito
+ */
+struct forma_s {
+    const struct geometria_s * geometria;  //!< Geometria registrada o calculada, NULL si la forma está libre
+    struct geometria_s calculada;          //!< Geometria de un tamaño que no fue registrado
+    uint16_t solapes[CANTIDAD_SEGMENTOS_TEXTO]; //!< Máscara de los segmentos cuya área se superpone con cada uno
+};
+
+/**
+ * @brief Juego de caracteres que muestra un tipo de panel
+ */
+struct juego_s {
+    const uint16_t * mascaras; //!< Segmentos encendidos de cada caracter, desde el código primero
+    uint8_t primero;           //!< Código del primer caracter de la tabla
+    uint8_t cantidad;          //!< Cantidad de caracteres de la tabla
+    uint8_t cero;              //!< Código de la cifra cero, las demás cifras le siguen en orden
+    uint8_t apagado;           //!< Código del caracter con todos los segmentos apagados
+    uint8_t segmentos;         //!< Cantidad de segmentos de la geometria de los caracteres
+};
+
+/**
+ * @brief Caracteres pre-dibujados para un tamaño de digito
+ *
+ * Cada caracter se guarda como una secuencia de bandas de filas iguales. Una banda empieza con la cantidad de filas
+ * que la forman, seguida de las corridas de una fila. Las corridas guardan el indice del color y no el color, así
+ * todos los paneles del mismo tamaño comparten la cache aunque usen colores distintos.
+ */
+struct cache_s {
+    uint16_t alto;                          //!< Alto de los digitos, cero si la cache está libre
+    uint16_t ancho;                         //!< Ancho de los digitos
+    uint16_t inicio[CANTIDAD_CARACTERES];   //!< Posición de la primera banda de cada caracter en las corridas
+    uint16_t palabras;                      //!< Cantidad de palabras de las corridas usadas por la cache
+};
 
 struct panel_s {
     struct punto_s origen;
@@ -67,13 +122,23 @@ struct panel_s {
     uint16_t encendido;
     uint16_t apagado;
     uint16_t fondo;
-    struct segmentos_s segmentos;
-    uint8_t valores[MAXIMO_DIGITOS];
+    const struct forma_s * forma; //!< Geometria de los segmentos, compartida con los paneles del mismo tamaño
+    const struct juego_s * juego; //!< Caracteres que muestra el panel
+    uint8_t * valores;                             //!< Caracter mostrado en cada digito
+    uint8_t * separadores;                         //!< Separador a la derecha de cada digito y si está apagado
+    uint8_t propia[MEMORIA_PANEL(MAXIMO_DIGITOS)]; //!< Estado de los digitos si el llamador no da memoria
+    uint16_t separacion;                           //!< Ancho en pixeles de la columna de cada separador
+    struct cache_s * cache; //!< Caracteres pre-dibujados, NULL si el panel dibuja por segmentos
+    uint16_t generacion;    //!< Cambia cada vez que se libera la instancia, invalida las referencias anteriores
+    uint8_t siguiente;      //!< Próxima instancia de la lista de libres, mientras la instancia está libre
 };
 
+//! @brief Puntero a una instancia de panel, solo se usa dentro de la biblioteca
+typedef struct panel_s * instancia_t;
+
 /* === Private variable declarations =============================================================================== */
 
-static const uint8_t DIGITOS[] = {
+static const uint16_t DIGITOS[CANTIDAD_CARACTERES] = {
     0x3F, 0x06, 0x5B, 0x4F, // 0,1,2,3
     0x66, 0x6D, 0x7D, 0x07, // 4,5,6,7
     0x7F, 0x6F, 0x77, 0x7C, // 8,9,A,B
@@ -81,131 +146,697 @@ static const uint8_t DIGITOS[] = {
     0x00,
 };
 
+//! @brief Segmentos de los caracteres de los paneles de texto, los que no figuran quedan apagados
+static const uint16_t LETRAS[CANTIDAD_LETRAS] = {
+    ['*' - PRIMERA_LETRA] = SEGMENTO_G1 | SEGMENTO_G2 | SEGMENTO_H | SEGMENTO_I | SEGMENTO_J | SEGMENTO_K | SEGMENTO_L |
+                            SEGMENTO_M,
+    ['+' - PRIMERA_LETRA] = SEGMENTO_G1 | SEGMENTO_G2 | SEGMENTO_I | SEGMENTO_L,
+    ['-' - PRIMERA_LETRA] = SEGMENTO_G1 | SEGMENTO_G2,
+    ['/' - PRIMERA_LETRA] = SEGMENTO_J | SEGMENTO_K,
+    ['0' - PRIMERA_LETRA] = SEGMENTO_A | SEGMENTO_B | SEGMENTO_C | SEGMENTO_D | SEGMENTO_E | SEGMENTO_F | SEGMENTO_J |
+                            SEGMENTO_K,
+    ['1' - PRIMERA_LETRA] = SEGMENTO_B | SEGMENTO_C | SEGMENTO_J,
+    ['2' - PRIMERA_LETRA] = SEGMENTO_A | SEGMENTO_B | SEGMENTO_G1 | SEGMENTO_G2 | SEGMENTO_E | SEGMENTO_D,
+    ['3' - PRIMERA_LETRA] = SEGMENTO_A | SEGMENTO_B | SEGMENTO_G2 | SEGMENTO_C | SEGMENTO_D,
+    ['4' - PRIMERA_LETRA] = SEGMENTO_F | SEGMENTO_G1 | SEGMENTO_G2 | SEGMENTO_B | SEGMENTO_C,
+    ['5' - PRIMERA_LETRA] = SEGMENTO_A | SEGMENTO_F | SEGMENTO_G1 | SEGMENTO_G2 | SEGMENTO_C | SEGMENTO_D,
+    ['6' - PRIMERA_LETRA] = SEGMENTO_A | SEGMENTO_F | SEGMENTO_G1 | SEGMENTO_G2 | SEGMENTO_C | SEGMENTO_D | SEGMENTO_E,
+    ['7' - PRIMERA_LETRA] = SEGMENTO_A | SEGMENTO_B | SEGMENTO_C,
+    ['8' - PRIMERA_LETRA] = SEGMENTO_A | SEGMENTO_B | SEGMENTO_C | SEGMENTO_D | SEGMENTO_E | SEGMENTO_F | SEGMENTO_G1 |
+                            SEGMENTO_G2,
+    ['9' - PRIMERA_LETRA] = SEGMENTO_A | SEGMENTO_B | SEGMENTO_C | SEGMENTO_D | SEGMENTO_F | SEGMENTO_G1 | SEGMENTO_G2,
+    ['<' - PRIMERA_LETRA] = SEGMENTO_J | SEGMENTO_M,
+    ['=' - PRIMERA_LETRA] = SEGMENTO_G1 | SEGMENTO_G2 | SEGMENTO_D,
+    ['>' - PRIMERA_LETRA] = SEGMENTO_H | SEGMENTO_K,
+    ['?' - PRIMERA_LETRA] = SEGMENTO_A | SEGMENTO_B | SEGMENTO_G2 | SEGMENTO_L,
+    ['A' - PRIMERA_LETRA] = SEGMENTO_A | SEGMENTO_B | SEGMENTO_C | SEGMENTO_E | SEGMENTO_F | SEGMENTO_G1 | SEGMENTO_G2,
+    ['B' - PRIMERA_LETRA] = SEGMENTO_A | SEGMENTO_B | SEGMENTO_C | SEGMENTO_D | SEGMENTO_G2 | SEGMENTO_I | SEGMENTO_L,
+    ['C' - PRIMERA_LETRA] = SEGMENTO_A | SEGMENTO_D | SEGMENTO_E | SEGMENTO_F,
+    ['D' - PRIMERA_LETRA] = SEGMENTO_A | SEGMENTO_B | SEGMENTO_C | SEGMENTO_D | SEGMENTO_I | SEGMENTO_L,
+    ['E' - PRIMERA_LETRA] = SEGMENTO_A | SEGMENTO_D | SEGMENTO_E | SEGMENTO_F | SEGMENTO_G1,
+    ['F' - PRIMERA_LETRA] = SEGMENTO_A | SEGMENTO_E | SEGMENTO_F | SEGMENTO_G1,
+    ['G' - PRIMERA_LETRA] = SEGMENTO_A | SEGMENTO_C | SEGMENTO_D | SEGMENTO_E | SEGMENTO_F | SEGMENTO_G2,
+    ['H' - PRIMERA_LETRA] = SEGMENTO_B | SEGMENTO_C | SEGMENTO_E | SEGMENTO_F | SEGMENTO_G1 | SEGMENTO_G2,
+    ['I' - PRIMERA_LETRA] = SEGMENTO_A | SEGMENTO_D | SEGMENTO_I | SEGMENTO_L,
+    ['J' - PRIMERA_LETRA] = SEGMENTO_B | SEGMENTO_C | SEGMENTO_D | SEGMENTO_E,
+    ['K' - PRIMERA_LETRA] = SEGMENTO_E | SEGMENTO_F | SEGMENTO_G1 | SEGMENTO_J | SEGMENTO_M,
+    ['L' - PRIMERA_LETRA] = SEGMENTO_D | SEGMENTO_E | SEGMENTO_F,
+    ['M' - PRIMERA_LETRA] = SEGMENTO_B | SEGMENTO_C | SEGMENTO_E | SEGMENTO_F | SEGMENTO_H | SEGMENTO_J,
+    ['N' - PRIMERA_LETRA] = SEGMENTO_B | SEGMENTO_C | SEGMENTO_E | SEGMENTO_F | SEGMENTO_H | SEGMENTO_M,
+    ['O' - PRIMERA_LETRA] = SEGMENTO_A | SEGMENTO_B | SEGMENTO_C | SEGMENTO_D | SEGMENTO_E | SEGMENTO_F,
+    ['P' - PRIMERA_LETRA] = SEGMENTO_A | SEGMENTO_B | SEGMENTO_E | SEGMENTO_F | SEGMENTO_G1 | SEGMENTO_G2,
+    ['Q' - PRIMERA_LETRA] = SEGMENTO_A | SEGMENTO_B | SEGMENTO_C | SEGMENTO_D | SEGMENTO_E | SEGMENTO_F | SEGMENTO_M,
+    ['R' - PRIMERA_LETRA] = SEGMENTO_A | SEGMENTO_B | SEGMENTO_E | SEGMENTO_F | SEGMENTO_G1 | SEGMENTO_G2 | SEGMENTO_M,
+    ['S' - PRIMERA_LETRA] = SEGMENTO_A | SEGMENTO_F | SEGMENTO_G1 | SEGMENTO_G2 | SEGMENTO_C | SEGMENTO_D,
+    ['T' - PRIMERA_LETRA] = SEGMENTO_A | SEGMENTO_I | SEGMENTO_L,
+    ['U' - PRIMERA_LETRA] = SEGMENTO_B | SEGMENTO_C | SEGMENTO_D | SEGMENTO_E | SEGMENTO_F,
+    ['V' - PRIMERA_LETRA] = SEGMENTO_E | SEGMENTO_F | SEGMENTO_J | SEGMENTO_K,
+    ['W' - PRIMERA_LETRA] = SEGMENTO_B | SEGMENTO_C | SEGMENTO_E | SEGMENTO_F | SEGMENTO_K | SEGMENTO_M,
+    ['X' - PRIMERA_LETRA] = SEGMENTO_H | SEGMENTO_J | SEGMENTO_K | SEGMENTO_M,
+    ['Y' - PRIMERA_LETRA] = SEGMENTO_H | SEGMENTO_J | SEGMENTO_L,
+    ['Z' - PRIMERA_LETRA] = SEGMENTO_A | SEGMENTO_D | SEGMENTO_J | SEGMENTO_K,
+    ['_' - PRIMERA_LETRA] = SEGMENTO_D,
+};
+
+//! @brief Cifras hexadecimales de 7 segmentos de los paneles de digitos
+static const struct juego_s NUMEROS = {DIGITOS, 0, CANTIDAD_CARACTERES, 0, CARACTER_APAGADO, CANTIDAD_SEGMENTOS};
+
+//! @brief Letras, cifras y signos de 14 segmentos de los paneles de texto
+static const struct juego_s TEXTO = {LETRAS, PRIMERA_LETRA, CANTIDAD_LETRAS, '0', ' ', CANTIDAD_SEGMENTOS_TEXTO};
+
 /* === Private function declarations =============================================================================== */
 
 /* === Public variable definitions ================================================================================= */
 
 /* === Private variable definitions ================================================================================ */
 
+static struct panel_s instancias[MAXIMO_PANELES]; //!< Instancias de paneles, las libres tienen cero digitos
+static uint8_t primera_libre;                       //!< Primera instancia de la lista de libres
+static uint8_t instancias_iniciadas;                //!< La lista de libres se arma en la primera creación
+
+static struct forma_s formas[MAXIMO_GEOMETRIAS]; //!< Geometrias de los tamaños de digito en uso
+
+static struct cache_s caches[MAXIMO_CACHES]; //!< Caches de caracteres pre-dibujados, una por tamaño de digito
+static uint16_t corridas[MEMORIA_CACHES];    //!< Memoria compartida por las corridas de todas las caches
+static uint16_t corridas_usadas;             //!< Cantidad de palabras ocupadas en la memoria de las corridas
+
 /* === Private function definitions ================================================================================ */
 
-panel_t CrearInstancia(void) {
-    static struct panel_s instancias[MAXIMO_PANELES];
+static uint16_t Menor(uint16_t a, uint16_t b) {
+    return a < b ? a : b;
+}
 
-    for (int indice = 0; indice < MAXIMO_PANELES; indice++) {
-        if (instancias[indice].digitos == 0) {
-            return &(instancias[indice]);
+static uint16_t Mayor(uint16_t a, uint16_t b) {
+    return a > b ? a : b;
+}
+
+static int PuntoEnSegmento(area_t segmento, uint16_t x, uint16_t y) {
+    return (x >= Menor(segmento->desde.x, segmento->hasta.x)) && (x <= Mayor(segmento->desde.x, segmento->hasta.x)) &&
+           (y >= Menor(segmento->desde.y, segmento->hasta.y)) && (y <= Mayor(segmento->desde.y, segmento->hasta.y));
+}
+
+static int SegmentosSuperpuestos(area_t uno, area_t otro) {
+    // Los extremos de los segmentos b y c se guardan invertidos, por eso se comparan los limites de cada eje
+    return (Menor(uno->desde.x, uno->hasta.x) <= Mayor(otro->desde.x, otro->hasta.x)) &&
+           (Menor(otro->desde.x, otro->hasta.x) <= Mayor(uno->desde.x, uno->hasta.x)) &&
+           (Menor(uno->desde.y, uno->hasta.y) <= Mayor(otro->desde.y, otro->hasta.y)) &&
+           (Menor(otro->desde.y, otro->hasta.y) <= Mayor(uno->desde.y, uno->hasta.y));
+}
+
+static instancia_t CrearInstancia(void) {
+    instancia_t self = NULL;
+
+    if (!instancias_iniciadas) {
+        for (int indice = 0; indice < MAXIMO_PANELES; indice++) {
+            instancias[indice].siguiente = (indice + 1 < MAXIMO_PANELES) ? indice + 1 : SIN_INSTANCIAS;
+        }
+        primera_libre = 0;
+        instancias_iniciadas = 1;
+    }
+
+    if (primera_libre != SIN_INSTANCIAS) {
+        self = &(instancias[primera_libre]);
+        primera_libre = self->siguiente;
+    }
+    return self;
+}
+
+static instancia_t ObtenerInstancia(panel_t panel) {
+    uint16_t indice = PANEL_INDICE(panel);
+
+    if ((panel == PANEL_INVALIDO) || (indice >= MAXIMO_PANELES)) {
+        return NULL;
+    }
+    // Una referencia de otra generación apunta a un panel que ya fue liberado
+    assert(instancias[indice].generacion == PANEL_GENERACION(panel));
+    if ((instancias[indice].generacion != PANEL_GENERACION(panel)) || (instancias[indice].digitos == 0)) {
+        return NULL;
+    }
+    return &(instancias[indice]);
+}
+
+static struct forma_s * BuscarForma(uint16_t alto, uint16_t ancho, uint8_t segmentos) {
+    for (int indice = 0; indice < MAXIMO_GEOMETRIAS; indice++) {
+        if ((formas[indice].geometria != NULL) && (formas[indice].geometria->alto == alto) &&
+            (formas[indice].geometria->ancho == ancho) && (formas[indice].geometria->cantidad == segmentos)) {
+            return &(formas[indice]);
         }
     }
     return NULL;
 }
 
-void CalcularGeometria(panel_t self) {
+static struct forma_s * FormaLibre(void) {
+    for (int indice = 0; indice < MAXIMO_GEOMETRIAS; indice++) {
+        if (formas[indice].geometria == NULL) {
+            return &(formas[indice]);
+        }
+    }
+    return NULL;
+}
 
-    if (self->ancho == 0) {
-        self->ancho = (self->alto * 60) / 100;
+static void CalcularSolapes(struct forma_s * forma) {
+    const struct geometria_s * geometria = forma->geometria;
+
+    // En los digitos chicos la separación es nula y los segmentos comparten pixeles en las esquinas
+    // Las diagonales se comparan por el rectangulo que las contiene
+    for (int i = 0; i < geometria->cantidad; i++) {
+        forma->solapes[i] = 0;
+        for (int j = 0; j < geometria->cantidad; j++) {
+            if ((i != j) && SegmentosSuperpuestos(&(geometria->segmentos[i]), &(geometria->segmentos[j]))) {
+                forma->solapes[i] |= (1 << j);
+            }
+        }
+    }
+}
+
+static const struct forma_s * ObtenerForma(uint16_t alto, uint16_t ancho, uint8_t segmentos) {
+    struct forma_s * forma = BuscarForma(alto, ancho, segmentos);
+
+    if (forma == NULL) {
+        // El tamaño no fue registrado, se calcula una única vez con las mismas proporciones
+        forma = FormaLibre();
+        if (forma && (segmentos == CANTIDAD_SEGMENTOS_TEXTO)) {
+            forma->calculada = (struct geometria_s)GEOMETRIA_14SEG(alto, ancho);
+        } else if (forma) {
+            forma->calculada = (struct geometria_s)GEOMETRIA_7SEG(alto, ancho);
+        }
+        if (forma) {
+            forma->geometria = &(forma->calculada);
+            CalcularSolapes(forma);
+        }
+    }
+    return forma;
+}
+
+static uint16_t ColumnaDigito(instancia_t self, uint8_t posicion) {
+    uint16_t columna = self->origen.x + posicion * self->ancho;
+
+    // Cada separador a la izquierda del digito lo corre el ancho de su columna
+    for (int indice = 0; indice < posicion; indice++) {
+        if (self->separadores[indice] & SEPARADOR_TIPO) {
+            columna += self->separacion;
+        }
+    }
+    return columna;
+}
+
+static void PintarSeparador(instancia_t self, uint8_t posicion) {
+    uint8_t separador = self->separadores[posicion];
+    uint16_t color = (separador & SEPARADOR_APAGADO) ? self->apagado : self->encendido;
+    uint16_t lado = GEOMETRIA_MARGEN(self->alto) + GEOMETRIA_BARRA(self->alto);
+    uint16_t x = ColumnaDigito(self, posicion) + self->ancho + self->separacion / 2 - lado / 2;
+    uint16_t y;
+
+    // Los puntos son cuadrados del ancho de una barra con su margen, centrados en la columna del separador
+    if ((separador & SEPARADOR_TIPO) == SEPARADOR_PUNTO) {
+        y = self->origen.y + self->alto - GEOMETRIA_MARGEN(self->alto) - lado + 1;
+        ILI9341DrawFilledRectangle(x, y, x + lado - 1, y + lado - 1, color);
+    } else if ((separador & SEPARADOR_TIPO) == SEPARADOR_DOS_PUNTOS) {
+        y = self->origen.y + self->alto / 3 - lado / 2;
+        ILI9341DrawFilledRectangle(x, y, x + lado - 1, y + lado - 1, color);
+        y = self->origen.y + (2 * self->alto) / 3 - lado / 2;
+        ILI9341DrawFilledRectangle(x, y, x + lado - 1, y + lado - 1, color);
+    }
+}
+
+static uint16_t CodificarFila(instancia_t self, uint16_t segmentos, uint16_t y, uint16_t * fila) {
+    uint16_t cantidad = 0, longitud = 0;
+    uint8_t color, actual = COLOR_FONDO;
+
+    for (uint16_t x = 0; x <= self->ancho; x++) {
+        // Cuando los segmentos se superponen queda el color del último, igual que al dibujarlos en orden
+        color = COLOR_FONDO;
+        for (int indice = 0; indice < self->forma->geometria->cantidad; indice++) {
+            if (PuntoEnSegmento(&(self->forma->geometria->segmentos[indice]), x, y)) {
+                color = (segmentos & (1 << indice)) ? COLOR_ENCENDIDO : COLOR_APAGADO;
+            }
+        }
+        if ((longitud > 0) && (color != actual)) {
+            fila[cantidad++] = CORRIDA(actual, longitud);
+            longitud = 0;
+        }
+        actual = color;
+        longitud++;
+    }
+    fila[cantidad++] = CORRIDA(actual, longitud);
+    return cantidad;
+}
+
+static int CodificarCaracter(instancia_t self, uint16_t segmentos) {
+    uint16_t fila[MAXIMO_CORRIDAS_FILA];
+    uint16_t cantidad, anterior = 0, banda = 0;
+
+    for (uint16_t y = 0; y <= self->alto; y++) {
+        cantidad = CodificarFila(self, segmentos, y, fila);
+        if ((cantidad == anterior) && (memcmp(&corridas[banda + 1], fila, cantidad * sizeof(uint16_t)) == 0)) {
+            // La fila es igual a la anterior, se agrega a la banda actual
+            corridas[banda]++;
+        } else {
+            if (corridas_usadas + 1 + cantidad > MEMORIA_CACHES) {
+                return 0;
+            }
+            banda = corridas_usadas;
+            corridas[banda] = 1;
+            memcpy(&corridas[banda + 1], fila, cantidad * sizeof(uint16_t));
+            corridas_usadas += 1 + cantidad;
+            anterior = cantidad;
+        }
     }
+    return 1;
+}
 
-    uint16_t ancho_barra = (self->alto * 7) / 100;
-    uint16_t margen = (ancho_barra * 75) / 100;
-    uint16_t separacion = (self->alto * 2) / 100;
+static struct cache_s * CrearCache(instancia_t self) {
+    struct cache_s * cache = NULL;
+    uint16_t inicio = corridas_usadas;
 
-    segmentos_t s = &(self->segmentos);
+    for (int indice = 0; indice < MAXIMO_CACHES; indice++) {
+        if ((caches[indice].alto == self->alto) && (caches[indice].ancho == self->ancho)) {
+            return &(caches[indice]);
+        } else if ((cache == NULL) && (caches[indice].alto == 0)) {
+            cache = &(caches[indice]);
+        }
+    }
 
-    s->a.desde.x = s->d.desde.x = s->g.desde.x = margen + ancho_barra + separacion;
-    s->a.hasta.x = s->d.hasta.x = s->g.hasta.x = self->ancho - (margen + ancho_barra + separacion);
-    s->a.hasta.y = margen + ancho_barra;
-    s->g.desde.y = (self->alto - ancho_barra) / 2;
-    s->g.hasta.y = (self->alto + ancho_barra) / 2;
-    s->d.desde.y = self->alto - (margen + ancho_barra);
+    if (cache) {
+        for (int caracter = 0; caracter < CANTIDAD_CARACTERES; caracter++) {
+            cache->inicio[caracter] = corridas_usadas;
+            if (!CodificarCaracter(self, DIGITOS[caracter])) {
+                // No hay memoria para todos los caracteres, se descarta lo codificado
+                corridas_usadas = inicio;
+                return NULL;
+            }
+        }
+        cache->alto = self->alto;
+        cache->ancho = self->ancho;
+        cache->palabras = corridas_usadas - inicio;
+    }
+    return cache;
+}
 
-    s->a.desde.y = s->b.desde.y = s->f.desde.y = margen;
-    s->b.hasta.y = s->f.hasta.y = (self->alto - separacion) / 2;
-    s->c.desde.y = s->e.desde.y = (self->alto + separacion) / 2;
-    s->d.hasta.y = s->c.hasta.y = s->e.hasta.y = self->alto - margen;
+static void DibujarCaracter(instancia_t self, uint8_t posicion, uint8_t valor) {
+    const uint16_t colores[] = {
+        [COLOR_FONDO] = self->fondo,
+        [COLOR_APAGADO] = self->apagado,
+        [COLOR_ENCENDIDO] = self->encendido,
+    };
+    const uint16_t * banda = &corridas[self->cache->inicio[valor]];
+    const uint16_t * corrida = banda;
+    uint16_t x = ColumnaDigito(self, posicion);
+
+    ILI9341BeginArea(x, self->origen.y, x + self->ancho, self->origen.y + self->alto);
+    for (uint16_t y = 0; y <= self->alto; y += banda[0], banda = corrida) {
+        for (uint16_t fila = 0; fila < banda[0]; fila++) {
+            corrida = &banda[1];
+            for (uint16_t columna = 0; columna <= self->ancho; corrida++) {
+                ILI9341WriteColor(colores[CORRIDA_COLOR(*corrida)], CORRIDA_LONGITUD(*corrida));
+                columna += CORRIDA_LONGITUD(*corrida);
+            }
+        }
+    }
+    ILI9341EndArea();
+}
 
-    s->e.desde.x = s->f.desde.x = margen;
-    s->e.hasta.x = s->f.hasta.x = margen + ancho_barra;
-    s->b.desde.x = s->c.desde.x = self->ancho - margen;
-    s->b.hasta.x = s->c.hasta.x = self->ancho - (margen + ancho_barra);
+static uint32_t CostoSegmentos(instancia_t self, uint16_t cambios) {
+    uint32_t costo = 0;
+    area_t segmento;
+
+    for (int indice = 0; indice < self->forma->geometria->cantidad; indice++) {
+        if (cambios & (1 << indice)) {
+            segmento = &(self->forma->geometria->segmentos[indice]);
+            costo += COSTO_VENTANA + 2 * (Mayor(segmento->desde.x, segmento->hasta.x) -
+                                          Menor(segmento->desde.x, segmento->hasta.x) + 1) *
+                                             (Mayor(segmento->desde.y, segmento->hasta.y) -
+                                              Menor(segmento->desde.y, segmento->hasta.y) + 1);
+        }
+    }
+    return costo;
 }
 
-void BorrarDigito(panel_t self, uint8_t digito) {
+static void BorrarCelda(instancia_t self, uint8_t digito) {
     struct area_s area;
 
-    area.desde.x = self->origen.x + digito * self->ancho;
+    area.desde.x = ColumnaDigito(self, digito);
     area.desde.y = self->origen.y;
-    area.hasta.x = self->origen.x + (digito + 1) * self->ancho;
+    area.hasta.x = area.desde.x + self->ancho;
     area.hasta.y = self->origen.y + self->alto;
 
     ILI9341DrawFilledRectangle(area.desde.x, area.desde.y, area.hasta.x, area.hasta.y, self->fondo);
+    self->valores[digito] = DIGITO_SIN_DIBUJAR;
 }
 
-void DibujarSegmento(panel_t self, uint8_t digito, area_t segmento, uint16_t color) {
+void DibujarSegmento(instancia_t self, uint8_t digito, area_t segmento, uint16_t color) {
+    uint16_t columna = ColumnaDigito(self, digito);
     struct area_s area;
 
-    area.desde.x = self->origen.x + digito * self->ancho + segmento->desde.x;
+    area.desde.x = columna + segmento->desde.x;
     area.desde.y = self->origen.y + segmento->desde.y;
-    area.hasta.x = self->origen.x + digito * self->ancho + segmento->hasta.x;
+    area.hasta.x = columna + segmento->hasta.x;
     area.hasta.y = self->origen.y + segmento->hasta.y;
 
     ILI9341DrawFilledRectangle(area.desde.x, area.desde.y, area.hasta.x, area.hasta.y, color);
 }
 
-/* === Public function implementation ============================================================================== */
+static void DibujarDiagonal(instancia_t self, uint8_t digito, area_t segmento, uint16_t color) {
+    uint16_t columna = ColumnaDigito(self, digito);
+    int barra = Mayor(GEOMETRIA_BARRA(self->alto), 1);
+    int paso = Mayor(barra / 2, 1);
+    int izquierda = Menor(segmento->desde.x, segmento->hasta.x);
+    int derecha = Mayor(segmento->desde.x, segmento->hasta.x);
+    int x0 = segmento->desde.x, y0 = segmento->desde.y;
+    int x1 = segmento->hasta.x, y1 = segmento->hasta.y;
+    int sentido, centro, desde, fin;
+
+    if (y0 > y1) {
+        x0 = segmento->hasta.x, y0 = segmento->hasta.y;
+        x1 = segmento->desde.x, y1 = segmento->desde.y;
+    }
+    // La recta pasa a media barra de los bordes, así los escalones de los extremos no se recortan
+    sentido = (x0 < x1) ? 1 : -1;
+    if (derecha - izquierda >= barra) {
+        x0 += sentido * (barra / 2);
+        x1 -= sentido * (barra / 2);
+    }
+
+    // Cada escalón es un rectangulo del ancho de una barra centrado sobre la recta que une las esquinas
+    for (int y = y0; y <= y1; y += paso) {
+        fin = (y + paso - 1 < y1) ? y + paso - 1 : y1;
+        centro = x0 + ((x1 - x0) * (y + fin - 2 * y0)) / (2 * Mayor(y1 - y0, 1));
+        desde = centro - barra / 2;
+        if (desde + barra - 1 > derecha) {
+            desde = derecha - barra + 1;
+        }
+        if (desde < izquierda) {
+            desde = izquierda;
+        }
+        ILI9341DrawFilledRectangle(columna + desde, self->origen.y + y, columna + Menor(desde + barra - 1, derecha),
+                                   self->origen.y + fin, color);
+    }
+}
+
+static void PintarCelda(instancia_t self, uint8_t posicion, uint8_t valor, uint16_t cambios, int completo) {
+    const struct geometria_s * geometria = self->forma->geometria;
+    uint16_t segmentos = self->juego->mascaras[valor - self->juego->primero];
+
+    if (!completo) {
+        // Un segmento que se repinta tapa las esquinas de los que se le superponen, que tambien se repintan
+        for (uint16_t anterior = 0; anterior != cambios;) {
+            anterior = cambios;
+            for (int indice = 0; indice < geometria->cantidad; indice++) {
+                if (anterior & (1 << indice)) {
+                    cambios |= self->forma->solapes[indice];
+                }
+            }
+        }
+    }
+
+    if (self->cache && (completo || CostoSegmentos(self, cambios) >
+                                        COSTO_VENTANA + 2 * (uint32_t)(self->ancho + 1) * (self->alto + 1))) {
+        // Enviar la celda completa desde la cache es mas barato que pintar los segmentos por separado
+        DibujarCaracter(self, posicion, valor);
+        cambios = 0;
+    } else if (completo) {
+        BorrarCelda(self, posicion);
+    }
+    self->valores[posicion] = valor;
+
+    for (int indice = 0; indice < geometria->cantidad; indice++) {
+        if ((cambios & (1 << indice)) && (geometria->diagonales & (1 << indice))) {
+            DibujarDiagonal(self, posicion, &(geometria->segmentos[indice]),
+                            segmentos & (1 << indice) ? self->encendido : self->apagado);
+        } else if (cambios & (1 << indice)) {
+            DibujarSegmento(self, posicion, &(geometria->segmentos[indice]),
+                            segmentos & (1 << indice) ? self->encendido : self->apagado);
+        }
+    }
+}
+
+static panel_t CrearInstanciaPanel(const struct juego_s * juego, uint16_t x, uint16_t y, uint16_t digitos,
+                                   const char * formato, uint16_t separacion, uint16_t alto, uint16_t ancho,
+                                   uint16_t encendido, uint16_t apagado, uint16_t fondo, uint8_t * memoria) {
+    const struct forma_s * forma;
+    instancia_t self = NULL;
+    panel_t panel = PANEL_INVALIDO;
+
+    if (ancho == 0) {
+        ancho = (alto * 60) / 100;
+    }
+    forma = ObtenerForma(alto, ancho, juego->segmentos);
+    if (forma) {
+        self = CrearInstancia();
+    }
 
-panel_t CrearPanel(uint16_t x, uint16_t y, uint16_t digitos, uint16_t alto, uint16_t ancho, uint16_t encendido,
-                   uint16_t apagado, uint16_t fondo) {
-    panel_t self = CrearInstancia();
     if (self) {
+        panel = PANEL(self - instancias, self->generacion);
+        self->cache = NULL;
         self->origen.x = x;
         self->origen.y = y;
         self->alto = alto;
         self->ancho = ancho;
 
-        if (digitos > MAXIMO_DIGITOS) {
-            self->digitos = MAXIMO_DIGITOS;
-        } else if (digitos < 1) {
-            self->digitos = 1;
-        } else {
-            self->digitos = digitos;
+        if (memoria == NULL) {
+            memoria = self->propia;
+            if (digitos > MAXIMO_DIGITOS) {
+                digitos = MAXIMO_DIGITOS;
+            }
         }
+        self->digitos = (digitos < 1) ? 1 : digitos;
+        self->valores = memoria;
+        self->separadores = memoria + self->digitos;
 
         self->encendido = encendido;
         self->apagado = apagado;
         self->fondo = fondo;
 
-        CalcularGeometria(self);
+        self->forma = forma;
+        self->juego = juego;
+        self->separacion = separacion;
+
+        memset(self->separadores, SEPARADOR_NINGUNO, self->digitos);
+        for (int i = 0; formato && *formato; formato++) {
+            if (*formato == '8') {
+                i++;
+            } else if ((*formato == '.') && (i > 0) && (i <= self->digitos)) {
+                self->separadores[i - 1] = SEPARADOR_PUNTO;
+            } else if ((*formato == ':') && (i > 0) && (i <= self->digitos)) {
+                self->separadores[i - 1] = SEPARADOR_DOS_PUNTOS;
+            }
+        }
+        for (int i = 0; i < self->digitos; i++) {
+            self->valores[i] = DIGITO_SIN_DIBUJAR;
+            DibujarDigito(panel, i, juego->apagado);
+        }
+    }
+    return panel;
+}
+
+/* === Public function implementation ============================================================================== */
+
+panel_t CrearPanel(uint16_t x, uint16_t y, uint16_t digitos, uint16_t alto, uint16_t ancho, uint16_t encendido,
+                   uint16_t apagado, uint16_t fondo) {
+    return CrearInstanciaPanel(&NUMEROS, x, y, digitos, NULL, 0, alto, ancho, encendido, apagado, fondo, NULL);
+}
+
+panel_t CrearPanelFormato(uint16_t x, uint16_t y, const char * formato, uint16_t separacion, uint16_t alto,
+                          uint16_t ancho, uint16_t encendido, uint16_t apagado, uint16_t fondo, uint8_t * memoria) {
+    uint16_t digitos = 0;
+
+    for (const char * caracter = formato; *caracter; caracter++) {
+        if (*caracter == '8') {
+            digitos++;
+        }
     }
+    return CrearInstanciaPanel(&NUMEROS, x, y, digitos, formato, separacion, alto, ancho, encendido, apagado, fondo,
+                               memoria);
+}
+
+panel_t CrearPanelTexto(uint16_t x, uint16_t y, uint16_t caracteres, uint16_t alto, uint16_t ancho, uint16_t encendido,
+                        uint16_t apagado, uint16_t fondo) {
+    return CrearInstanciaPanel(&TEXTO, x, y, caracteres, NULL, 0, alto, ancho, encendido, apagado, fondo, NULL);
+}
 
-    for (int i = 0; i < self->digitos; i++) {
-        DibujarDigito(self, i, 0xFF);
+void LiberarPanel(panel_t panel) {
+    instancia_t self = ObtenerInstancia(panel);
+
+    if (self) {
+        self->digitos = 0;
+        self->generacion++;
+        self->siguiente = primera_libre;
+        primera_libre = self - instancias;
+    }
+}
+
+void DibujarDigito(panel_t panel, uint8_t posicion, uint8_t valor) {
+    instancia_t self = ObtenerInstancia(panel);
+
+    if (self && (posicion < self->digitos)) {
+        const struct juego_s * juego = self->juego;
+        uint16_t cambios;
+        int completo = (self->valores[posicion] == DIGITO_SIN_DIBUJAR);
+
+        if ((valor < juego->primero) || (valor >= juego->primero + juego->cantidad)) {
+            valor = juego->apagado;
+        }
+
+        if (completo) {
+            // La celda no tiene un caracter dibujado, se pintan el fondo y todos los segmentos
+            cambios = (1 << self->forma->geometria->cantidad) - 1;
+        } else {
+            // Solo se pintan los segmentos que cambian de estado respecto al valor dibujado
+            cambios = juego->mascaras[self->valores[posicion] - juego->primero] ^ juego->mascaras[valor - juego->primero];
+        }
+        PintarCelda(self, posicion, valor, cambios, completo);
+
+        // El separador se pinta junto con el digito a su izquierda, después solo cambia al parpadear
+        if (completo && (self->separadores[posicion] & SEPARADOR_TIPO)) {
+            PintarSeparador(self, posicion);
+        }
     }
-    return self;
 }
 
-void DibujarDigito(panel_t self, uint8_t posicion, uint8_t valor) {
-    if (posicion < self->digitos) {
-        uint8_t segmentos;
+void DibujarNumero(panel_t panel, uint32_t valor, uint8_t opciones) {
+    instancia_t self = ObtenerInstancia(panel);
+    uint8_t cifra;
+    int posicion, lote = 0;
 
-        self->valores[posicion] = valor;
-        if (valor > sizeof(DIGITOS)) {
-            self->valores[posicion] = sizeof(DIGITOS);
+    if (self == NULL) {
+        return;
+    }
+
+    // Las cifras se sacan de las unidades hacia la izquierda, el panel puede tener cualquier cantidad de digitos
+    for (posicion = self->digitos - 1; posicion >= 0; posicion--) {
+        cifra = self->juego->cero + valor % 10;
+        if ((opciones & NUMERO_SIN_CEROS) && (valor == 0) && (posicion < self->digitos - 1)) {
+            cifra = self->juego->apagado;
+        }
+        valor = valor / 10;
+        if (cifra != self->valores[posicion]) {
+            if (!lote) {
+                // El bus se reserva recien cuando hay algo para dibujar
+                ILI9341StartBatch();
+                lote = 1;
+            }
+            DibujarDigito(panel, posicion, cifra);
         }
-        segmentos = DIGITOS[self->valores[posicion]];
+    }
+    if (lote) {
+        ILI9341EndBatch();
+    }
+}
 
-        BorrarDigito(self, posicion);
-        DibujarSegmento(self, posicion, &(self->segmentos.a), segmentos & SEGMENTO_A ? self->encendido : self->apagado);
-        DibujarSegmento(self, posicion, &(self->segmentos.b), segmentos & SEGMENTO_B ? self->encendido : self->apagado);
-        DibujarSegmento(self, posicion, &(self->segmentos.c), segmentos & SEGMENTO_C ? self->encendido : self->apagado);
-        DibujarSegmento(self, posicion, &(self->segmentos.d), segmentos & SEGMENTO_D ? self->encendido : self->apagado);
-        DibujarSegmento(self, posicion, &(self->segmentos.e), segmentos & SEGMENTO_E ? self->encendido : self->apagado);
-        DibujarSegmento(self, posicion, &(self->segmentos.f), segmentos & SEGMENTO_F ? self->encendido : self->apagado);
-        DibujarSegmento(self, posicion, &(self->segmentos.g), segmentos & SEGMENTO_G ? self->encendido : self->apagado);
+void DibujarTexto(panel_t panel, const char * texto) {
+    instancia_t self = ObtenerInstancia(panel);
+    uint8_t caracter;
+    int lote = 0;
+
+    if (self == NULL) {
+        return;
+    }
+
+    for (int posicion = 0; posicion < self->digitos; posicion++) {
+        caracter = *texto ? (uint8_t)*texto++ : ' ';
+        if ((caracter >= 'a') && (caracter <= 'z')) {
+            caracter = caracter - 'a' + 'A';
+        }
+        if (caracter != self->valores[posicion]) {
+            if (!lote) {
+                ILI9341StartBatch();
+                lote = 1;
+            }
+            DibujarDigito(panel, posicion, caracter);
+        }
+    }
+    if (lote) {
+        ILI9341EndBatch();
     }
 }
 
-void ChangeColor(panel_t self, uint16_t encendido){
+void ChangeColor(panel_t panel, uint16_t encendido, bool repintar) {
+    instancia_t self = ObtenerInstancia(panel);
+    uint8_t valor;
+
+    if (self == NULL) {
+        return;
+    }
     self->encendido = encendido;
+
+    if (!repintar) {
+        // Los segmentos encendidos conservan el color anterior hasta que se dibuja completo cada digito
+        for (int i = 0; i < self->digitos; i++) {
+            self->valores[i] = DIGITO_SIN_DIBUJAR;
+        }
+        return;
+    }
+
+    // Solo se repintan los segmentos encendidos, y los que se les superponen, de los digitos que están dibujados
+    ILI9341StartBatch();
+    for (int posicion = 0; posicion < self->digitos; posicion++) {
+        valor = self->valores[posicion];
+        if (valor != DIGITO_SIN_DIBUJAR) {
+            PintarCelda(self, posicion, valor, self->juego->mascaras[valor - self->juego->primero], 0);
+            if ((self->separadores[posicion] & SEPARADOR_TIPO) && !(self->separadores[posicion] & SEPARADOR_APAGADO)) {
+                PintarSeparador(self, posicion);
+            }
+        }
+    }
+    ILI9341EndBatch();
+}
+
+int UsarCacheDigitos(panel_t panel) {
+    instancia_t self = ObtenerInstancia(panel);
+
+    // La cache tiene lugar para los caracteres de los digitos, los paneles de texto pintan por segmentos
+    if (self && (self->juego == &NUMEROS)) {
+        self->cache = CrearCache(self);
+    }
+    return self && self->cache;
+}
+
+void BorrarDigito(panel_t panel, uint8_t digito) {
+    instancia_t self = ObtenerInstancia(panel);
+
+    if (self && (digito < self->digitos)) {
+        BorrarCelda(self, digito);
+    }
+}
+
+int RegistrarGeometria(const geometria_t * geometria) {
+    struct forma_s * forma = BuscarForma(geometria->alto, geometria->ancho, geometria->cantidad);
+
+    if (forma == NULL) {
+        forma = FormaLibre();
+        if (forma) {
+            forma->geometria = geometria;
+            CalcularSolapes(forma);
+        }
+    }
+    return forma != NULL;
 }
+
+void DibujarSeparador(panel_t panel, uint8_t posicion, bool encendido) {
+    instancia_t self = ObtenerInstancia(panel);
+
+    if (self && (posicion < self->digitos) && (self->separadores[posicion] & SEPARADOR_TIPO)) {
+        if (encendido) {
+            self->separadores[posicion] &= ~SEPARADOR_APAGADO;
+        } else {
+            self->separadores[posicion] |= SEPARADOR_APAGADO;
+        }
+        // Si el digito no está dibujado el separador se pinta junto con él
+        if (self->valores[posicion] != DIGITO_SIN_DIBUJAR) {
+            PintarSeparador(self, posicion);
+        }
+    }
+}
+
+uint32_t MemoriaCacheDigitos(void) {
+    uint32_t memoria = 0;
+
+    for (int indice = 0; indice < MAXIMO_CACHES; indice++) {
+        if (caches[indice].alto != 0) {
+            memoria += sizeof(struct cache_s) + caches[indice].palabras * sizeof(uint16_t);
+        }
+    }
+    return memoria;
+}
+
 /* === End of documentation ======================================================================================== */
@@ -27,6 +27,7 @@ SPDX-License-Identifier: MIT
 /* === Headers files inclusions ==================================================================================== */
 
 #include <stdint.h>
+#include <stdbool.h>
 
 /* === Cabecera C++ ================================================================================================ */
 
@@ -41,15 +42,188 @@ extern "C" {
 #define MAXIMO_PANELES 15
 #endif
 
-//! @brief Cantidad máxima de digitos que se pueden mostrar en un panel
+//! @brief Cantidad máxima de digitos de un panel que guarda su estado en la propia instancia
 #ifndef MAXIMO_DIGITOS
 #define MAXIMO_DIGITOS 4
 #endif
 
+//! @brief Cantidad máxima de tamaños de digito distintos con caracteres pre-dibujados
+#ifndef MAXIMO_CACHES
+#define MAXIMO_CACHES 4
+#endif
+
+//! @brief Cantidad de palabras de 16 bits reservadas para las corridas de los caracteres pre-dibujados
+#ifndef MEMORIA_CACHES
+#define MEMORIA_CACHES 4096
+#endif
+
+//! @brief Cantidad máxima de tamaños de digito distintos que pueden usar los paneles al mismo tiempo
+#ifndef MAXIMO_GEOMETRIAS
+#define MAXIMO_GEOMETRIAS 6
+#endif
+
+//! @brief Cantidad de segmentos de un digito
+#define CANTIDAD_SEGMENTOS 7
+
+//! @brief Cantidad de segmentos de un caracter de los paneles de texto
+#define CANTIDAD_SEGMENTOS_TEXTO 14
+
+//! @brief Ancho de la barra de un segmento para un alto de digito
+#define GEOMETRIA_BARRA(alto) (((alto)*7) / 100)
+
+//! @brief Margen entre el borde del digito y los segmentos para un alto de digito
+#define GEOMETRIA_MARGEN(alto) ((GEOMETRIA_BARRA(alto) * 75) / 100)
+
+//! @brief Separación entre segmentos vecinos para un alto de digito
+#define GEOMETRIA_SEPARACION(alto) (((alto)*2) / 100)
+
+//! @brief Distancia del borde del digito al borde interno de los segmentos verticales
+#define GEOMETRIA_INTERNO(alto) (GEOMETRIA_MARGEN(alto) + GEOMETRIA_BARRA(alto))
+
+//! @brief Distancia del borde del digito a los extremos de los segmentos horizontales
+#define GEOMETRIA_EXTREMO(alto) (GEOMETRIA_INTERNO(alto) + GEOMETRIA_SEPARACION(alto))
+
+//! @brief Distancia del borde izquierdo del caracter al segmento vertical central de los paneles de texto
+#define GEOMETRIA_CENTRO(alto, ancho) (((ancho)-GEOMETRIA_BARRA(alto)) / 2)
+
+//! @brief Máscara de los segmentos diagonales h, j, k y m de los paneles de texto
+#define GEOMETRIA_DIAGONALES ((1 << 8) | (1 << 10) | (1 << 11) | (1 << 13))
+
+/**
+ * @brief Geometria de los segmentos de un digito de un tamaño, calculada por el compilador
+ *
+ * Se usa para declarar tablas constantes con los tamaños de digito de una aplicación, que se registran con
+ * @ref RegistrarGeometria. Las coordenadas son relativas a la esquina superior izquierda del digito y los
+ * segmentos siguen el orden a, b, c, d, e, f y g. Los extremos horizontales de b y c quedan invertidos.
+ *
+ * @param  alto      Alto en pixeles del caracter
+ * @param  ancho     Ancho en pixeles del caracter, no puede ser cero
+ */
+#define GEOMETRIA_7SEG(alto, ancho)                                                                                    \
+    {                                                                                                                  \
+        (alto), (ancho),                                                                                               \
+        {                                                                                                              \
+            {{GEOMETRIA_EXTREMO(alto), GEOMETRIA_MARGEN(alto)},                                                        \
+             {(ancho)-GEOMETRIA_EXTREMO(alto), GEOMETRIA_INTERNO(alto)}},                                              \
+            {{(ancho)-GEOMETRIA_MARGEN(alto), GEOMETRIA_MARGEN(alto)},                                                 \
+             {(ancho)-GEOMETRIA_INTERNO(alto), ((alto)-GEOMETRIA_SEPARACION(alto)) / 2}},                              \
+            {{(ancho)-GEOMETRIA_MARGEN(alto), ((alto) + GEOMETRIA_SEPARACION(alto)) / 2},                              \
+             {(ancho)-GEOMETRIA_INTERNO(alto), (alto)-GEOMETRIA_MARGEN(alto)}},                                        \
+            {{GEOMETRIA_EXTREMO(alto), (alto)-GEOMETRIA_INTERNO(alto)},                                                \
+             {(ancho)-GEOMETRIA_EXTREMO(alto), (alto)-GEOMETRIA_MARGEN(alto)}},                                        \
+            {{GEOMETRIA_MARGEN(alto), ((alto) + GEOMETRIA_SEPARACION(alto)) / 2},                                      \
+             {GEOMETRIA_INTERNO(alto), (alto)-GEOMETRIA_MARGEN(alto)}},                                                \
+            {{GEOMETRIA_MARGEN(alto), GEOMETRIA_MARGEN(alto)},                                                         \
+             {GEOMETRIA_INTERNO(alto), ((alto)-GEOMETRIA_SEPARACION(alto)) / 2}},                                      \
+            {{GEOMETRIA_EXTREMO(alto), ((alto)-GEOMETRIA_BARRA(alto)) / 2},                                            \
+             {(ancho)-GEOMETRIA_EXTREMO(alto), ((alto) + GEOMETRIA_BARRA(alto)) / 2}},                                 \
+        },                                                                                                             \
+        CANTIDAD_SEGMENTOS, 0                                                                                          \
+    }
+
+/**
+ * @brief Geometria de los segmentos de un caracter de los paneles de texto, calculada por el compilador
+ *
+ * Los segmentos siguen el orden a, b, c, d, e, f, g1, g2, h, i, j, k, l y m: los seis del contorno son los mismos
+ * de @ref GEOMETRIA_7SEG, g1 y g2 son las mitades del segmento central, i y l los verticales del centro, y h, j, k
+ * y m las diagonales. Las diagonales se dibujan como una escalera de rectangulos que une su esquina desde con su
+ * esquina hasta, así el texto usa los mismos rellenos de rectangulos que los digitos.
+ *
+ * @param  alto      Alto en pixeles del caracter
+ * @param  ancho     Ancho en pixeles del caracter, no puede ser cero
+ */
+#define GEOMETRIA_14SEG(alto, ancho)                                                                                   \
+    {                                                                                                                  \
+        (alto), (ancho),                                                                                               \
+        {                                                                                                              \
+            {{GEOMETRIA_EXTREMO(alto), GEOMETRIA_MARGEN(alto)},                                                        \
+             {(ancho)-GEOMETRIA_EXTREMO(alto), GEOMETRIA_INTERNO(alto)}},                                              \
+            {{(ancho)-GEOMETRIA_MARGEN(alto), GEOMETRIA_MARGEN(alto)},                                                 \
+             {(ancho)-GEOMETRIA_INTERNO(alto), ((alto)-GEOMETRIA_SEPARACION(alto)) / 2}},                              \
+            {{(ancho)-GEOMETRIA_MARGEN(alto), ((alto) + GEOMETRIA_SEPARACION(alto)) / 2},                              \
+             {(ancho)-GEOMETRIA_INTERNO(alto), (alto)-GEOMETRIA_MARGEN(alto)}},                                        \
+            {{GEOMETRIA_EXTREMO(alto), (alto)-GEOMETRIA_INTERNO(alto)},                                                \
+             {(ancho)-GEOMETRIA_EXTREMO(alto), (alto)-GEOMETRIA_MARGEN(alto)}},                                        \
+            {{GEOMETRIA_MARGEN(alto), ((alto) + GEOMETRIA_SEPARACION(alto)) / 2},                                      \
+             {GEOMETRIA_INTERNO(alto), (alto)-GEOMETRIA_MARGEN(alto)}},                                                \
+            {{GEOMETRIA_MARGEN(alto), GEOMETRIA_MARGEN(alto)},                                                         \
+             {GEOMETRIA_INTERNO(alto), ((alto)-GEOMETRIA_SEPARACION(alto)) / 2}},                                      \
+            {{GEOMETRIA_EXTREMO(alto), ((alto)-GEOMETRIA_BARRA(alto)) / 2},                                            \
+             {((ancho)-GEOMETRIA_SEPARACION(alto)) / 2 - 1, ((alto) + GEOMETRIA_BARRA(alto)) / 2}},                    \
+            {{((ancho) + GEOMETRIA_SEPARACION(alto)) / 2, ((alto)-GEOMETRIA_BARRA(alto)) / 2},                         \
+             {(ancho)-GEOMETRIA_EXTREMO(alto), ((alto) + GEOMETRIA_BARRA(alto)) / 2}},                                 \
+            {{GEOMETRIA_EXTREMO(alto) + 1, GEOMETRIA_EXTREMO(alto) + 1},                                               \
+             {GEOMETRIA_CENTRO(alto, ancho) - GEOMETRIA_SEPARACION(alto) - 1,                                          \
+              ((alto)-GEOMETRIA_BARRA(alto)) / 2 - GEOMETRIA_SEPARACION(alto) - 1}},                                   \
+            {{GEOMETRIA_CENTRO(alto, ancho), GEOMETRIA_EXTREMO(alto) + 1},                                             \
+             {GEOMETRIA_CENTRO(alto, ancho) + GEOMETRIA_BARRA(alto),                                                   \
+              ((alto)-GEOMETRIA_BARRA(alto)) / 2 - GEOMETRIA_SEPARACION(alto) - 1}},                                   \
+            {{(ancho)-GEOMETRIA_EXTREMO(alto) - 1, GEOMETRIA_EXTREMO(alto) + 1},                                       \
+             {GEOMETRIA_CENTRO(alto, ancho) + GEOMETRIA_BARRA(alto) + GEOMETRIA_SEPARACION(alto) + 1,                  \
+              ((alto)-GEOMETRIA_BARRA(alto)) / 2 - GEOMETRIA_SEPARACION(alto) - 1}},                                   \
+            {{GEOMETRIA_CENTRO(alto, ancho) - GEOMETRIA_SEPARACION(alto) - 1,                                          \
+              ((alto) + GEOMETRIA_BARRA(alto)) / 2 + GEOMETRIA_SEPARACION(alto) + 1},                                  \
+             {GEOMETRIA_EXTREMO(alto) + 1, (alto)-GEOMETRIA_EXTREMO(alto) - 1}},                                       \
+            {{GEOMETRIA_CENTRO(alto, ancho), ((alto) + GEOMETRIA_BARRA(alto)) / 2 + GEOMETRIA_SEPARACION(alto) + 1},   \
+             {GEOMETRIA_CENTRO(alto, ancho) + GEOMETRIA_BARRA(alto), (alto)-GEOMETRIA_EXTREMO(alto) - 1}},             \
+            {{GEOMETRIA_CENTRO(alto, ancho) + GEOMETRIA_BARRA(alto) + GEOMETRIA_SEPARACION(alto) + 1,                  \
+              ((alto) + GEOMETRIA_BARRA(alto)) / 2 + GEOMETRIA_SEPARACION(alto) + 1},                                  \
+             {(ancho)-GEOMETRIA_EXTREMO(alto) - 1, (alto)-GEOMETRIA_EXTREMO(alto) - 1}},                               \
+        },                                                                                                             \
+        CANTIDAD_SEGMENTOS_TEXTO, GEOMETRIA_DIAGONALES                                                                 \
+    }
+
+//! @brief Opción de @ref DibujarNumero para mostrar los ceros a la izquierda, el número ocupa todo el panel
+#define NUMERO_CEROS 0x00
+
+//! @brief Opción de @ref DibujarNumero para dejar apagados los ceros a la izquierda, las unidades siempre se muestran
+#define NUMERO_SIN_CEROS 0x01
+
+//! @brief Posición sin separador a la derecha del digito
+#define SEPARADOR_NINGUNO 0
+
+//! @brief Punto decimal a la derecha del digito, se indica con '.' en el formato de @ref CrearPanelFormato
+#define SEPARADOR_PUNTO 1
+
+//! @brief Dos puntos a la derecha del digito, se indican con ':' en el formato de @ref CrearPanelFormato
+#define SEPARADOR_DOS_PUNTOS 2
+
+//! @brief Bytes que necesita el estado de un panel de n digitos cuando lo guarda en memoria del llamador
+#define MEMORIA_PANEL(digitos) (2 * (digitos))
+
+//! @brief Referencia que no corresponde a ningún panel, la devuelve @ref CrearPanel cuando no quedan instancias
+#define PANEL_INVALIDO 0
+
 /* === Public data type declarations =============================================================================== */
 
-//! @brief Tipo de dato para referenciar a un panel de digitos
-typedef struct panel_s * panel_t;
+//! @brief Punto de la pantalla, o de un digito cuando se usa en una geometria
+struct punto_s {
+    uint16_t x;
+    uint16_t y;
+};
+
+//! @brief Rectangulo entre dos esquinas opuestas, incluidas
+struct area_s {
+    struct punto_s desde;
+    struct punto_s hasta;
+};
+
+//! @brief Geometria de los segmentos de un caracter, se declara con @ref GEOMETRIA_7SEG o @ref GEOMETRIA_14SEG
+typedef struct geometria_s {
+    uint16_t alto;                                     //!< Alto en pixeles del caracter
+    uint16_t ancho;                                    //!< Ancho en pixeles del caracter
+    struct area_s segmentos[CANTIDAD_SEGMENTOS_TEXTO]; //!< Segmentos en el orden de los bits de las máscaras
+    uint8_t cantidad;                                  //!< Cantidad de segmentos usados del arreglo
+    uint16_t diagonales;                               //!< Máscara de los segmentos que se dibujan en diagonal
+} geometria_t;
+
+/**
+ * @brief Tipo de dato para referenciar a un panel de digitos
+ *
+ * La referencia combina la instancia del panel con una generación que cambia cuando el panel se libera, así una
+ * referencia a un panel liberado no modifica el panel que se creó después en la misma instancia.
+ */
+typedef uint32_t panel_t;
 
 /* === Public variable declarations ================================================================================ */
 
@@ -66,22 +240,161 @@ typedef struct panel_s * panel_t;
  * @param  encendido Color de los segmentos encendidos de los digitos
  * @param  apagado   Color de los segmentos apagados de los digitos
  * @param  fondo     Color de fondo del panel
- * @return panel_t   Puntero al panel creado
+ * @return panel_t   Referencia al panel creado, @ref PANEL_INVALIDO si no quedan instancias libres
  */
 panel_t CrearPanel(uint16_t x, uint16_t y, uint16_t digitos, uint16_t alto, uint16_t ancho, uint16_t encendido,
                    uint16_t apagado, uint16_t fondo);
 
+/**
+ * @brief Función que crea un panel de digitos de 7 segmentos con separadores entre ellos
+ *
+ * Cada separador ocupa una columna propia entre dos digitos, que no se borra con el fondo del panel. Los puntos se
+ * dibujan como rectangulos del ancho de una barra con su margen, sin rasterizar circulos.
+ *
+ * @param  x          Posición horizontal de la esquina superior derecha del panel
+ * @param  y          Posición vertical de la esquina superior derecha del panel
+ * @param  formato    Un '8' por cada digito, seguido de '.' o ':' si tiene un separador a la derecha, ej "88:"
+ * @param  separacion Ancho en pixeles de la columna de cada separador
+ * @param  alto       Alto en pixeles del caracter del panel
+ * @param  ancho      Ancho en pixeles del caracter del panel
+ * @param  encendido  Color de los segmentos encendidos de los digitos y de los separadores
+ * @param  apagado    Color de los segmentos apagados de los digitos y de los separadores
+ * @param  fondo      Color de fondo del panel
+ * @param  memoria    Al menos @ref MEMORIA_PANEL bytes para el estado de los digitos, que deben existir mientras
+ *                    exista el panel, o NULL para guardarlo en la instancia con hasta @ref MAXIMO_DIGITOS digitos
+ * @return panel_t    Referencia al panel creado, @ref PANEL_INVALIDO si no quedan instancias libres
+ */
+panel_t CrearPanelFormato(uint16_t x, uint16_t y, const char * formato, uint16_t separacion, uint16_t alto,
+                          uint16_t ancho, uint16_t encendido, uint16_t apagado, uint16_t fondo, uint8_t * memoria);
+
+/**
+ * @brief Función que crea un panel de texto con caracteres de 14 segmentos
+ *
+ * El panel muestra letras, cifras y algunos signos con las mismas funciones de los paneles de digitos, y solo
+ * repinta los segmentos que cambian entre un texto y el siguiente.
+ *
+ * @param  x          Posición horizontal de la esquina superior derecha del panel
+ * @param  y          Posición vertical de la esquina superior derecha del panel
+ * @param  caracteres Cantidad de caracteres que se pueden mostrar en el panel, hasta @ref MAXIMO_DIGITOS
+ * @param  alto       Alto en pixeles del caracter del panel
+ * @param  ancho      Ancho en pixeles del caracter del panel
+ * @param  encendido  Color de los segmentos encendidos de los caracteres
+ * @param  apagado    Color de los segmentos apagados de los caracteres
+ * @param  fondo      Color de fondo del panel
+ * @return panel_t    Referencia al panel creado, @ref PANEL_INVALIDO si no quedan instancias libres
+ */
+panel_t CrearPanelTexto(uint16_t x, uint16_t y, uint16_t caracteres, uint16_t alto, uint16_t ancho, uint16_t encendido,
+                        uint16_t apagado, uint16_t fondo);
+
+/**
+ * @brief Función para encender o apagar el separador a la derecha de un digito, por ejemplo para que parpadee
+ *
+ * @param self       Referencia al panel creado con la funcion @ref CrearPanelFormato
+ * @param posicion   Posición del digito a la izquierda del separador
+ * @param encendido  true para mostrarlo con el color de los segmentos encendidos, false con el de los apagados
+ */
+void DibujarSeparador(panel_t self, uint8_t posicion, bool encendido);
+
+/**
+ * @brief Función para registrar la geometria de un tamaño de digito calculada por el compilador
+ *
+ * Los paneles de ese tamaño usan la tabla registrada sin calcular nada al crearse. Los tamaños que no se registran
+ * se calculan al crear el primer panel, y en los dos casos todos los paneles del mismo tamaño comparten la geometria.
+ *
+ * @param geometria  Geometria declarada con @ref GEOMETRIA_7SEG o @ref GEOMETRIA_14SEG, debe existir mientras se
+ *                   usen los paneles
+ * @return int       Distinto de cero si la geometria quedó registrada, cero si no quedan lugares libres
+ */
+int RegistrarGeometria(const geometria_t * geometria);
+
+/**
+ * @brief Función para devolver la instancia de un panel que ya no se muestra
+ *
+ * La pantalla no se modifica. Las referencias al panel liberado dejan de ser validas y usarlas es un error.
+ *
+ * @param self       Referencia al panel creado con la funcion @ref CrearPanel
+ */
+void LiberarPanel(panel_t self);
+
 /**
  * @brief Función para actualizar el valor de un digito en un panel
  *
- * @param self       Puntero al panel creado con la funcion @ref CrearPanel
+ * Solo se redibujan los segmentos que cambian de estado respecto al valor mostrado. La celda completa se borra
+ * únicamente cuando el digito no fue dibujado todavía o fue borrado con @ref BorrarDigito.
+ *
+ * @param self       Referencia al panel creado con la funcion @ref CrearPanel
  * @param posicion   Posición del digito que se desea actualizar
- * @param valor      Valor que se desea mostrar en el digito
+ * @param valor      Valor que se desea mostrar en el digito, los valores fuera de rango dejan el digito apagado
  */
 void DibujarDigito(panel_t self, uint8_t posicion, uint8_t valor);
-void ChangeColor(panel_t self, uint16_t encendido);
+
+/**
+ * @brief Función para mostrar un número decimal en todos los digitos de un panel
+ *
+ * El número se descompone una sola vez y solo se dibujan los digitos que cambian respecto a los mostrados. Todos
+ * los digitos que cambian se envían a la pantalla en un mismo lote, sin que otro dispositivo use el bus entre ellos.
+ * Si el número tiene más cifras que el panel se muestran las de menor peso.
+ *
+ * @param self       Referencia al panel creado con la funcion @ref CrearPanel
+ * @param valor      Número que se desea mostrar
+ * @param opciones   @ref NUMERO_CEROS o @ref NUMERO_SIN_CEROS
+ */
+void DibujarNumero(panel_t self, uint32_t valor, uint8_t opciones);
+
+/**
+ * @brief Función para mostrar un texto en un panel de texto
+ *
+ * Las minúsculas se muestran como mayúsculas y los caracteres que no están en la tabla quedan apagados. Si el texto
+ * es más corto que el panel se completa con espacios, y si es más largo se muestran los primeros caracteres. Todos
+ * los caracteres que cambian se envían a la pantalla en un mismo lote.
+ *
+ * @param self       Referencia al panel creado con la funcion @ref CrearPanelTexto
+ * @param texto      Texto que se desea mostrar
+ */
+void DibujarTexto(panel_t self, const char * texto);
+
+/**
+ * @brief Función para cambiar el color de los segmentos encendidos de un panel
+ *
+ * Al repintar se envían en un mismo lote solo los segmentos encendidos de los digitos dibujados, y los separadores
+ * encendidos, sin borrar las celdas. Sin repintar el nuevo color se aplica cuando se actualiza cada digito, que se
+ * dibuja completo.
+ *
+ * @param self       Referencia al panel creado con la funcion @ref CrearPanel
+ * @param encendido  Nuevo color de los segmentos encendidos
+ * @param repintar   true para mostrar el nuevo color en el momento, false para esperar a la próxima actualización
+ */
+void ChangeColor(panel_t self, uint16_t encendido, bool repintar);
+
+/**
+ * @brief Función para borrar la celda de un digito con el color de fondo del panel
+ *
+ * @param self       Referencia al panel creado con la funcion @ref CrearPanel
+ * @param digito     Posición del digito que se desea borrar
+ */
 void BorrarDigito(panel_t self, uint8_t digito);
 
+/**
+ * @brief Función para que un panel dibuje sus digitos desde caracteres pre-dibujados
+ *
+ * Los 17 caracteres se codifican una sola vez por tamaño de digito como corridas de pixeles, y se comparten entre
+ * todos los paneles del mismo tamaño sin importar sus colores. Con la cache un digito que se dibuja completo se envía
+ * en una única ventana, y cuando cambian pocos segmentos se siguen pintando solo esos. La memoria que ocupan las
+ * corridas crece con el alto de los digitos, por eso la cache es opcional. Los paneles de texto tienen demasiados
+ * caracteres para pre-dibujarlos y siempre pintan por segmentos.
+ *
+ * @param self       Referencia al panel creado con la funcion @ref CrearPanel
+ * @return int       Distinto de cero si el panel usa la cache, cero si no hay memoria o es un panel de texto
+ */
+int UsarCacheDigitos(panel_t self);
+
+/**
+ * @brief Función para consultar la memoria usada por los caracteres pre-dibujados
+ *
+ * @return uint32_t  Cantidad de bytes ocupados por todas las caches, de los reservados con @ref MEMORIA_CACHES
+ */
+uint32_t MemoriaCacheDigitos(void);
+
 /* === End of documentation ======================================================================================== */
 
 #ifdef __cplusplus
@@ -1,136 +1,838 @@
 #include "display.h"
+#include "freertos/timers.h"
 #include "time_struct.h"
 #include "mode_op.h"
+#include "xpt2046.h"
+#include "esfera.h"
+#include "esp_timer.h"
+#include "esp_log.h"
 #include "stdio.h"
+#include "math.h"
 
 /**
- * @brief Resets the previous clock time array to zero for display updates.
- */
-#define RESET_CLOCK_ANT_0()      \
-    do                           \
-    {                            \
-        _clock_ant[0].hr = 0;    \
-        _clock_ant[0].min = 0;   \
-        _clock_ant[0].sec = 0;   \
-        _clock_ant[0].day = 0;   \
-        _clock_ant[0].month = 0; \
-        _clock_ant[0].year = 0;  \
-    } while (0)
-
-/**
- * @brief Draws a partial time (hundreds, tens, units, tenths) on the display.
- * @param panel_base The base panel for drawing integer parts.
- * @param centena The hundreds digit.
- * @param decena The tens digit.
- * @param unidad The units digit.
- * @param decima The tenths digit (requires a separate panel_t for decimals, suffixed with `_d`).
- */
-#define DIBUJAR_PARCIAL(panel_base, centena, decena, unidad, decima) \
-    DibujarDigito(panel_base, 2, unidad);                            \
-    DibujarDigito(panel_base, 1, decena);                            \
-    DibujarDigito(panel_base, 0, centena);                           \
-    DibujarDigito(panel_base##_d, 0, decima);
-
-/**
- * @brief Macro to reset the stopwatch display to its initial state (all zeros) and redraw static elements.
- */
-#define CRONO_RESET_PANTALLA()                                  \
-    do                                                          \
-    {                                                           \
-        ILI9341Fill(DIGITO_APAGADO);                            \
-        DibujarDigito(segundos, 2, unidad_ant);                 \
-        DibujarDigito(segundos, 1, decena_ant);                 \
-        DibujarDigito(segundos, 0, centena_ant);                \
-        DibujarDigito(decimas, 0, decima_ant);                  \
-        ILI9341DrawFilledCircle(178, 95, 5, DIGITO_ENCENDIDO);  \
-        ILI9341DrawFilledCircle(113, 160, 5, DIGITO_ENCENDIDO); \
-        ILI9341DrawFilledCircle(145, 220, 5, DIGITO_ENCENDIDO); \
-        ILI9341DrawFilledCircle(178, 280, 5, DIGITO_ENCENDIDO); \
-        DIBUJA_PARCIALES();                                     \
-    } while (0);
-
-/**
- * @brief Macro to draw all three partial (lap) times on the display.
- */
-#define DIBUJA_PARCIALES()                                     \
-    {                                                          \
-        DIBUJAR_PARCIAL(parcial1, parcial[0].centena,          \
-                        parcial[0].decena,                     \
-                        parcial[0].unidad, parcial[0].decima); \
-        DIBUJAR_PARCIAL(parcial2, parcial[1].centena,          \
-                        parcial[1].decena,                     \
-                        parcial[1].unidad, parcial[1].decima); \
-        DIBUJAR_PARCIAL(parcial3, parcial[2].centena,          \
-                        parcial[2].decena,                     \
-                        parcial[2].unidad, parcial[2].decima); \
-    }
-/**
- * @brief Macro to reset the clock/alarm display to its initial state (all zeros) and redraw static elements.
- */
-#define CLOCK_RESET_PANTALLA()                                 \
-    do                                                         \
-    {                                                          \
-        ILI9341Fill(DIGITO_APAGADO);                           \
-        DIBUJAR_HORA(rhoras, 0, 0);                            \
-        DIBUJAR_HORA(rminutos, 0, 0);                          \
-        DIBUJAR_HORA(rsegundos, 0, 0);                         \
-        DIBUJAR_HORA(rdia, 0, 0);                              \
-        DIBUJAR_MES(rmes, 0, 0);                               \
-        DIBUJAR_YEAR(ryear, 0, 0);                             \
-        ILI9341DrawFilledCircle(75, 55, 3, DIGITO_ENCENDIDO);  \
-        ILI9341DrawFilledCircle(75, 35, 3, DIGITO_ENCENDIDO);  \
-        ILI9341DrawFilledCircle(150, 55, 3, DIGITO_ENCENDIDO); \
-        ILI9341DrawFilledCircle(150, 35, 3, DIGITO_ENCENDIDO); \
-    } while (0);
+ * @name Screens
+ * @brief Sets of panels allocated together, only the panels of the screen shown are kept in the pool.
+ * @{
+ */
+#define PANTALLA_NINGUNA 0 /**< No panels allocated yet. */
+#define PANTALLA_RELOJ 1   /**< Clock panels, shared by the clock, alarm and settings modes. */
+#define PANTALLA_CRONO 2   /**< Stopwatch and lap panels. */
+#define PANTALLA_ESTADISTICAS 3 /**< Lap statistics, shown instead of the stopwatch screen. */
+#define PANTALLA_ANALOGICA 4    /**< Clock with hands, shown instead of the clock screen. */
+/** @} */
+
+/**
+ * @name Data Sources
+ * @brief Values shown by the widgets, the display task updates them and the renderer compares them with the drawn ones.
+ * @{
+ */
+#define FUENTE_TIEMPO 0     /**< Hours, minutes and seconds, as hhmmss. */
+#define FUENTE_DIA 1        /**< Day of the month. */
+#define FUENTE_MES 2        /**< Month, from 1 to 12. */
+#define FUENTE_YEAR 3       /**< Year. */
+#define FUENTE_CRONO 4      /**< Stopwatch time in tenths of a second. */
+#define FUENTE_PARCIAL 5    /**< First lap time shown, the older ones follow. */
+#define FUENTE_MODO 8       /**< Position of the mode bit, -1 without a mode. */
+#define FUENTE_VUELTA 9     /**< Number of the first lap shown when the laps are scrolled, -1 otherwise. */
+#define FUENTE_MEJOR 10     /**< Shortest lap in tenths of a second. */
+#define FUENTE_PEOR 11      /**< Longest lap in tenths of a second. */
+#define FUENTE_MEDIA 12     /**< Mean lap in tenths of a second. */
+#define FUENTE_DESVIO 13    /**< Standard deviation of the laps in tenths of a second. */
+#define FUENTE_DELTA 14     /**< Last lap minus the previous one in tenths of a second. */
+#define FUENTE_CANTIDAD 15  /**< Laps taken. */
+#define FUENTE_ETIQUETA 16  /**< Fixed value of the widgets that show a label. */
+#define CANTIDAD_FUENTES 17 /**< Number of data sources. */
+/** @} */
+
+#define MAXIMO_WIDGETS 11           /**< Widgets of the largest screen. */
+#define MAXIMO_CELDAS 8             /**< Cells of the widest widget. */
+#define MAXIMO_AREAS 16             /**< Areas painted by the widgets of the largest screen. */
+#define VALOR_SIN_DIBUJAR INT32_MIN /**< Drawn value of a widget whose panel was just created. */
+
+/**
+ * @brief Converts the value of a data source to the characters of the cells of a panel.
+ * @param valor Value of the data source.
+ * @param celdas Characters of the cells, from the leftmost one.
+ * @param cantidad Number of cells of the panel.
+ */
+typedef void (*formato_t)(int32_t valor, uint8_t *celdas, uint8_t cantidad);
+
+/**
+ * @brief Widget of a screen, a panel bound to a data source.
+ */
+typedef struct
+{
+    uint16_t x, y;        /**< Top left corner. */
+    const char *formato;  /**< Digits and separators of the panel, as for `CrearPanelFormato`. */
+    uint16_t separacion;  /**< Width of the separator columns. */
+    uint16_t alto;        /**< Height of the cells. */
+    uint16_t ancho;       /**< Width of the cells. */
+    uint16_t encendido;   /**< Color of the lit segments. */
+    bool texto;           /**< Letters of 14 segments instead of digits. */
+    uint8_t *memoria;     /**< State of panels wider than `MAXIMO_DIGITOS`, NULL for the others. */
+    bool diferible;       /**< Low priority, left for the next frame when the frame runs out of budget. */
+    const char *etiqueta; /**< Fixed text of the label widgets, NULL for the ones that show their source. */
+    uint8_t fuente;       /**< Data source shown. */
+    formato_t formatear;  /**< Conversion of the value to the characters of the cells. */
+} widget_t;
+
+/**
+ * @brief Screen rectangle, both corners included.
+ */
+typedef struct
+{
+    uint16_t x0, y0, x1, y1;
+} rectangulo_t;
+
+/**
+ * @brief Rectangle covered by consecutive digits of a panel, between two separators.
+ */
+#define AREA_DIGITOS(x, y, cantidad, alto, ancho) {(x), (y), (x) + (cantidad) * (ancho), (y) + (alto)}
+
+static void formato_numero(int32_t valor, uint8_t *celdas, uint8_t cantidad);
+static void formato_mes(int32_t valor, uint8_t *celdas, uint8_t cantidad);
+static void formato_modo(int32_t valor, uint8_t *celdas, uint8_t cantidad);
+static void formato_vuelta(int32_t valor, uint8_t *celdas, uint8_t cantidad);
+static void formato_absoluto(int32_t valor, uint8_t *celdas, uint8_t cantidad);
+static void formato_diferencia(int32_t valor, uint8_t *celdas, uint8_t cantidad);
+static void formato_cantidad(int32_t valor, uint8_t *celdas, uint8_t cantidad);
+
+/**
+ * @brief Digit sizes used by the screens, registered once so creating a panel doesn't compute its geometry.
+ */
+static const geometria_t GEOMETRIAS[] = {
+    GEOMETRIA_DIGITO,
+    GEOMETRIA_DIGITO_A,
+    GEOMETRIA_DIGITO_P,
+    GEOMETRIA_TEXTO_P,
+    GEOMETRIA_TEXTO_E,
+};
+
+/**
+ * @brief Month names shown on the clock, the first one stands for a month out of range.
+ */
+static const char *const NOMBRES_MES[] = {
+    "---", "ENE", "FEB", "MAR", "ABR", "MAY", "JUN", "JUL", "AGO", "SEP", "OCT", "NOV", "DIC",
+};
+
+/**
+ * @brief Names of the modes shown on the status panel, in the order of the mode bits.
+ */
+static const char *const NOMBRES_MODO[] = {
+    "HORA", "CONF", "ALRM", "ALCF", "CRON",
+};
+
+/**
+ * @brief Digit state of the clock panel, wider than the panels that keep their state in the pool.
+ */
+static uint8_t memoria_tiempo[MEMORIA_PANEL(6)];
+
+/**
+ * @brief Status panel shown on every screen, with the name of the mode or other text. The panels beside it in the
+ * bottom row start at x = 100, past its fourth cell.
+ */
+#define WIDGET_ESTADO(origen, formato_estado)                                                  \
+    {                                                                                          \
+        .x = 10, .y = 258, .formato = "8888", .alto = DIGITO_ALTO_E, .ancho = DIGITO_ANCHO_E,  \
+        .encendido = DIGITO_ENCENDIDO_Y, .texto = true, .diferible = true, .fuente = (origen), \
+        .formatear = (formato_estado),                                                         \
+    }
+
+/**
+ * @brief Lap time panel, the decimal point separates the tenths.
+ */
+#define WIDGET_PARCIAL(px, py, numero)                                                                   \
+    {                                                                                                    \
+        .x = (px), .y = (py), .formato = "888.8", .separacion = SEPARACION_PUNTO, .alto = DIGITO_ALTO_P, \
+        .ancho = DIGITO_ANCHO_P, .encendido = DIGITO_ENCENDIDO_VUELTA, .diferible = true,                \
+        .fuente = FUENTE_PARCIAL + (numero), .formatear = formato_numero,                                \
+    }
+
+/**
+ * @brief Label of a row of the statistics screen, centered on the height of the value.
+ */
+#define WIDGET_ETIQUETA(fila, nombre)                                                                           \
+    {                                                                                                           \
+        .x = 5, .y = 2 + (fila) * (DIGITO_ALTO_P + 1) + (DIGITO_ALTO_P - DIGITO_ALTO_E) / 2, .formato = "8888", \
+        .alto = DIGITO_ALTO_E, .ancho = DIGITO_ANCHO_E, .encendido = DIGITO_ENCENDIDO_DG, .texto = true,        \
+        .diferible = true, .etiqueta = (nombre), .fuente = FUENTE_ETIQUETA,                                     \
+    }
+
+/**
+ * @brief Time value of a row of the statistics screen, the decimal point separates the tenths.
+ */
+#define WIDGET_VALOR(fila, color, origen, formato_valor)                                                   \
+    {                                                                                                      \
+        .x = 100, .y = 2 + (fila) * (DIGITO_ALTO_P + 1), .formato = "888.8", .separacion = SEPARACION_PUNTO, \
+        .alto = DIGITO_ALTO_P, .ancho = DIGITO_ANCHO_P, .encendido = (color), .diferible = true,           \
+        .fuente = (origen), .formatear = (formato_valor),                                                  \
+    }
+
+/**
+ * @brief Widgets of the clock screen, shared by the clock, alarm and settings modes.
+ */
+static const widget_t WIDGETS_RELOJ[] = {
+    {
+        .x = 5, .y = 15, .formato = "88:88:88", .separacion = SEPARACION_DOS_PUNTOS, .alto = DIGITO_ALTO_A,
+        .ancho = DIGITO_ANCHO_A, .encendido = DIGITO_ENCENDIDO, .memoria = memoria_tiempo,
+        .fuente = FUENTE_TIEMPO, .formatear = formato_numero,
+    },
+    {
+        .x = 15, .y = 120, .formato = "88", .alto = DIGITO_ALTO_P, .ancho = DIGITO_ANCHO_P,
+        .encendido = DIGITO_ENCENDIDO_DG, .diferible = true, .fuente = FUENTE_DIA, .formatear = formato_numero,
+    },
+    {
+        .x = 47, .y = 180, .formato = "888", .alto = DIGITO_ALTO_P, .ancho = DIGITO_ANCHO_P,
+        .encendido = DIGITO_ENCENDIDO_DG, .texto = true, .diferible = true, .fuente = FUENTE_MES,
+        .formatear = formato_mes,
+    },
+    {
+        .x = 100, .y = 240, .formato = "8888", .alto = DIGITO_ALTO_P, .ancho = DIGITO_ANCHO_P,
+        .encendido = DIGITO_ENCENDIDO_DG, .diferible = true, .fuente = FUENTE_YEAR, .formatear = formato_numero,
+    },
+    WIDGET_ESTADO(FUENTE_MODO, formato_modo),
+};
+
+/**
+ * @brief Widgets of the stopwatch screen, the newest lap time shown goes first. While the laps are scrolled the
+ * status panel shows the number of the first one.
+ */
+static const widget_t WIDGETS_CRONO[] = {
+    {
+        .x = 5, .y = 15, .formato = "888.8", .separacion = SEPARACION_PUNTO, .alto = DIGITO_ALTO,
+        .ancho = DIGITO_ANCHO, .encendido = DIGITO_ENCENDIDO, .fuente = FUENTE_CRONO, .formatear = formato_numero,
+    },
+    WIDGET_PARCIAL(15, 120, 0),
+    WIDGET_PARCIAL(47, 180, 1),
+    WIDGET_PARCIAL(100, 240, 2),
+    WIDGET_ESTADO(FUENTE_VUELTA, formato_vuelta),
+};
+
+/**
+ * @brief Widgets of the statistics screen, one row per statistic and the number of laps on the status panel. The
+ * sign of the difference between the last two laps goes at the end of its label.
+ */
+static const widget_t WIDGETS_ESTADISTICAS[] = {
+    WIDGET_ETIQUETA(0, "MEJ"),
+    WIDGET_VALOR(0, DIGITO_ENCENDIDO_MEJOR, FUENTE_MEJOR, formato_numero),
+    WIDGET_ETIQUETA(1, "PEOR"),
+    WIDGET_VALOR(1, DIGITO_ENCENDIDO_PEOR, FUENTE_PEOR, formato_numero),
+    WIDGET_ETIQUETA(2, "MED"),
+    WIDGET_VALOR(2, DIGITO_ENCENDIDO, FUENTE_MEDIA, formato_numero),
+    WIDGET_ETIQUETA(3, "DESV"),
+    WIDGET_VALOR(3, DIGITO_ENCENDIDO, FUENTE_DESVIO, formato_numero),
+    {
+        .x = 5, .y = 2 + 4 * (DIGITO_ALTO_P + 1) + (DIGITO_ALTO_P - DIGITO_ALTO_E) / 2, .formato = "8888",
+        .alto = DIGITO_ALTO_E, .ancho = DIGITO_ANCHO_E, .encendido = DIGITO_ENCENDIDO_DG, .texto = true,
+        .diferible = true, .fuente = FUENTE_DELTA, .formatear = formato_diferencia,
+    },
+    WIDGET_VALOR(4, DIGITO_ENCENDIDO_Y, FUENTE_DELTA, formato_absoluto),
+    WIDGET_ESTADO(FUENTE_CANTIDAD, formato_cantidad),
+};
+
+/**
+ * @brief Widgets of the analog clock screen, the dial isn't a widget and is drawn by the display task.
+ */
+static const widget_t WIDGETS_ANALOGICO[] = {
+    WIDGET_ESTADO(FUENTE_MODO, formato_modo),
+};
+
+/**
+ * @brief Square covered by the dial of the analog clock.
+ */
+static const rectangulo_t AREA_ESFERA = {
+    ESFERA_X - ESFERA_RADIO, ESFERA_Y - ESFERA_RADIO, ESFERA_X + ESFERA_RADIO, ESFERA_Y + ESFERA_RADIO,
+};
+
+/**
+ * @brief Widgets of each screen, indexed by the screen number.
+ */
+static const struct
+{
+    const widget_t *widgets;
+    uint8_t cantidad;
+    const rectangulo_t *fondo; /**< Area painted by the screen outside its widgets, NULL if none. */
+} PANTALLAS[] = {
+    [PANTALLA_NINGUNA] = {NULL, 0},
+    [PANTALLA_RELOJ] = {WIDGETS_RELOJ, sizeof(WIDGETS_RELOJ) / sizeof(widget_t)},
+    [PANTALLA_CRONO] = {WIDGETS_CRONO, sizeof(WIDGETS_CRONO) / sizeof(widget_t)},
+    [PANTALLA_ESTADISTICAS] = {WIDGETS_ESTADISTICAS, sizeof(WIDGETS_ESTADISTICAS) / sizeof(widget_t)},
+    [PANTALLA_ANALOGICA] = {WIDGETS_ANALOGICO, sizeof(WIDGETS_ANALOGICO) / sizeof(widget_t), &AREA_ESFERA},
+};
+
+/**
+ * @brief Colors of the dial and the hands of the analog clock.
+ */
+static const colores_esfera_t COLORES_ESFERA = {
+    .fondo = DIGITO_APAGADO,
+    .esfera = DIGITO_FONDO,
+    .borde = DIGITO_ENCENDIDO_DG,
+    .minutos = DIGITO_ENCENDIDO_DG,
+    .horas = DIGITO_ENCENDIDO,
+    .aguja_hora = DIGITO_ENCENDIDO,
+    .aguja_minuto = DIGITO_ENCENDIDO,
+    .aguja_segundo = DIGITO_ENCENDIDO_R,
+};
+
+/**
+ * @brief Screen areas of the clock fields, in the order of `clock_settings.select`.
+ */
+static const rectangulo_t CAMPOS_RELOJ[] = {
+    AREA_DIGITOS(5, 15, 2, DIGITO_ALTO_A, DIGITO_ANCHO_A),   /* horas */
+    AREA_DIGITOS(80, 15, 2, DIGITO_ALTO_A, DIGITO_ANCHO_A),  /* minutos */
+    AREA_DIGITOS(155, 15, 2, DIGITO_ALTO_A, DIGITO_ANCHO_A), /* segundos */
+    AREA_DIGITOS(15, 120, 2, DIGITO_ALTO_P, DIGITO_ANCHO_P), /* día */
+    AREA_DIGITOS(47, 180, 3, DIGITO_ALTO_P, DIGITO_ANCHO_P), /* mes */
+    AREA_DIGITOS(100, 240, 4, DIGITO_ALTO_P, DIGITO_ANCHO_P), /* año */
+};
+
+/**
+ * @brief Cells of the clock fields, in the order of `clock_settings.select`, used to hide the field that blinks.
+ */
+static const struct
+{
+    uint8_t fuente;   /**< Data source of the field. */
+    uint8_t primero;  /**< First cell of the field in the panel. */
+    uint8_t cantidad; /**< Cells of the field. */
+} CELDAS_CAMPO[] = {
+    {FUENTE_TIEMPO, 0, 2}, /* horas */
+    {FUENTE_TIEMPO, 2, 2}, /* minutos */
+    {FUENTE_TIEMPO, 4, 2}, /* segundos */
+    {FUENTE_DIA, 0, 2},    /* día */
+    {FUENTE_MES, 0, 3},    /* mes */
+    {FUENTE_YEAR, 0, 4},   /* año */
+};
+
+/**
+ * @brief State of the widgets of the screen shown, in the order of its table.
+ */
+static struct
+{
+    panel_t panel;      /**< Panel of the widget. */
+    uint8_t celdas;     /**< Cells of the panel. */
+    int32_t dibujado;   /**< Value drawn on the panel. */
+    uint16_t ocultos;   /**< Cells erased by the blink, one bit per cell. */
+    uint16_t encendido; /**< Color of the lit segments of the panel. */
+} widgets[MAXIMO_WIDGETS];
+
+/**
+ * @brief Screen shown, only its panels are allocated.
+ */
+static int pantalla = PANTALLA_NINGUNA;
+
+/**
+ * @brief Display task, woken by `pantalla_notificar`. NULL until the task starts.
+ */
+static TaskHandle_t tarea_pantalla = NULL;
+
+/**
+ * @brief Phase of the field that blinks in the settings modes, or of the alarm flash, flipped by the blink timer.
+ */
+static volatile bool parpadeo_visible = true;
+
+/**
+ * @brief The LCD shows the colors inverted, for the hidden phase of the alarm flash.
+ */
+static bool invertida = false;
+
+/**
+ * @brief Frame statistics, read by `pantalla_estadisticas`.
+ */
+static estadisticas_pantalla_t estadisticas;
+
+static const char *TAG = "display";
+
+static void copiar_texto(const char *texto, uint8_t *celdas, uint8_t cantidad)
+{
+    for (int posicion = 0; posicion < cantidad; posicion++)
+    {
+        celdas[posicion] = *texto ? (uint8_t)*texto++ : ' ';
+    }
+}
+
+static void formato_numero(int32_t valor, uint8_t *celdas, uint8_t cantidad)
+{
+    /* Con ceros a la izquierda, como NUMERO_CEROS */
+    for (int posicion = cantidad - 1; posicion >= 0; posicion--)
+    {
+        celdas[posicion] = valor % 10;
+        valor = valor / 10;
+    }
+}
+
+static void formato_mes(int32_t valor, uint8_t *celdas, uint8_t cantidad)
+{
+    copiar_texto(NOMBRES_MES[((valor >= 0) && (valor <= 12)) ? valor : 0], celdas, cantidad);
+}
+
+static void formato_modo(int32_t valor, uint8_t *celdas, uint8_t cantidad)
+{
+    int modos = sizeof(NOMBRES_MODO) / sizeof(NOMBRES_MODO[0]);
+
+    copiar_texto(((valor >= 0) && (valor < modos)) ? NOMBRES_MODO[valor] : "", celdas, cantidad);
+}
+
+static void numero_con_letra(char letra, int32_t valor, uint8_t *celdas, uint8_t cantidad)
+{
+    /* La letra y el número alineado a la derecha */
+    copiar_texto((char[]){letra, '\0'}, celdas, cantidad);
+    for (int posicion = cantidad - 1; (posicion > 0) && ((valor > 0) || (posicion == cantidad - 1)); posicion--)
+    {
+        celdas[posicion] = '0' + valor % 10;
+        valor = valor / 10;
+    }
+}
+
+static void formato_vuelta(int32_t valor, uint8_t *celdas, uint8_t cantidad)
+{
+    if (valor < 0)
+    {
+        formato_modo(MASCARA_A_POSICION(MODO_CRONO >> 10), celdas, cantidad);
+    }
+    else
+    {
+        numero_con_letra('V', valor, celdas, cantidad);
+    }
+}
+
+static void formato_cantidad(int32_t valor, uint8_t *celdas, uint8_t cantidad)
+{
+    numero_con_letra('N', valor, celdas, cantidad);
+}
+
+static void formato_absoluto(int32_t valor, uint8_t *celdas, uint8_t cantidad)
+{
+    /* Los paneles de digitos no tienen signo, lo muestra otro widget */
+    formato_numero((valor < 0) ? -valor : valor, celdas, cantidad);
+}
+
+static void formato_diferencia(int32_t valor, uint8_t *celdas, uint8_t cantidad)
+{
+    copiar_texto((valor < 0) ? "DIF-" : (valor > 0) ? "DIF+" : "DIF", celdas, cantidad);
+}
+
+/**
+ * @brief Lists the areas painted complete by the widgets of a screen, and by the screen itself outside its widgets.
+ *
+ * The separator columns are left out, only their dots are painted. The areas of the state before the first screen
+ * are unknown, so the whole screen is returned for it.
+ * @param numero Screen number.
+ * @param separadores Include the separator columns, each widget is then a single area. The areas of the screen that
+ * is left use them so its dots are cleared too.
+ * @param areas Where the areas are stored, `MAXIMO_AREAS` of them at most.
+ * @return Number of areas.
+ */
+static int areas_pantalla(int numero, bool separadores, rectangulo_t *areas)
+{
+    int cantidad = 0;
+
+    if (numero == PANTALLA_NINGUNA)
+    {
+        areas[0] = (rectangulo_t){0, 0, ILI9341_WIDTH - 1, ILI9341_HEIGHT - 1};
+        return 1;
+    }
+    for (int i = 0; i < PANTALLAS[numero].cantidad; i++)
+    {
+        const widget_t *widget = &PANTALLAS[numero].widgets[i];
+        uint16_t x = widget->x, desde = widget->x;
+
+        /* Cada tramo de digitos entre separadores es un area, o todo el widget si se incluyen los separadores */
+        for (const char *formato = widget->formato;; formato++)
+        {
+            if ((*formato != '8') && (!separadores || (*formato == '\0')) && (x > desde) && (cantidad < MAXIMO_AREAS))
+            {
+                areas[cantidad++] = (rectangulo_t){desde, widget->y, x, widget->y + widget->alto};
+            }
+            if (*formato == '\0')
+            {
+                break;
+            }
+            x += (*formato == '8') ? widget->ancho : widget->separacion;
+            if ((*formato != '8') && !separadores)
+            {
+                desde = x;
+            }
+        }
+    }
+    if ((PANTALLAS[numero].fondo != NULL) && (cantidad < MAXIMO_AREAS))
+    {
+        areas[cantidad++] = *PANTALLAS[numero].fondo;
+    }
+    return cantidad;
+}
+
+/**
+ * @brief Clears the part of a rectangle that is outside all the areas of a list.
+ *
+ * The rectangle is split around the first area that overlaps it, and each piece left outside that area is checked
+ * against the rest of the list.
+ * @param rectangulo Rectangle to clear.
+ * @param areas Areas that are kept.
+ * @param cantidad Number of areas in the list.
+ */
+static void limpiar_fuera(rectangulo_t rectangulo, const rectangulo_t *areas, int cantidad)
+{
+    rectangulo_t pieza;
+
+    while ((cantidad > 0) && ((areas->x0 > rectangulo.x1) || (areas->x1 < rectangulo.x0) ||
+                              (areas->y0 > rectangulo.y1) || (areas->y1 < rectangulo.y0)))
+    {
+        areas++;
+        cantidad--;
+    }
+    if (cantidad == 0)
+    {
+        ILI9341DrawFilledRectangle(rectangulo.x0, rectangulo.y0, rectangulo.x1, rectangulo.y1, DIGITO_APAGADO);
+        return;
+    }
+
+    /* Franjas de arriba y de abajo con todo el ancho, y a los costados del area en las filas que comparten */
+    if (rectangulo.y0 < areas->y0)
+    {
+        pieza = (rectangulo_t){rectangulo.x0, rectangulo.y0, rectangulo.x1, areas->y0 - 1};
+        limpiar_fuera(pieza, areas + 1, cantidad - 1);
+        rectangulo.y0 = areas->y0;
+    }
+    if (rectangulo.y1 > areas->y1)
+    {
+        pieza = (rectangulo_t){rectangulo.x0, areas->y1 + 1, rectangulo.x1, rectangulo.y1};
+        limpiar_fuera(pieza, areas + 1, cantidad - 1);
+        rectangulo.y1 = areas->y1;
+    }
+    if (rectangulo.x0 < areas->x0)
+    {
+        pieza = (rectangulo_t){rectangulo.x0, rectangulo.y0, areas->x0 - 1, rectangulo.y1};
+        limpiar_fuera(pieza, areas + 1, cantidad - 1);
+    }
+    if (rectangulo.x1 > areas->x1)
+    {
+        pieza = (rectangulo_t){areas->x1 + 1, rectangulo.y0, rectangulo.x1, rectangulo.y1};
+        limpiar_fuera(pieza, areas + 1, cantidad - 1);
+    }
+}
+
+/**
+ * @brief Changes the screen shown, clearing only the areas of the previous one that the new one doesn't paint.
+ *
+ * The panels of the previous screen are released and the ones of the new screen are created, the next call to
+ * `renderizar` draws them complete.
+ * @param numero Screen to show.
+ * @return true if the screen changed, false if it was already shown.
+ */
+static bool usar_pantalla(int numero)
+{
+    rectangulo_t anteriores[MAXIMO_AREAS], siguientes[MAXIMO_AREAS];
+    int cantidad_anteriores, cantidad_siguientes;
+
+    if (numero == pantalla)
+    {
+        return false;
+    }
+
+    cantidad_anteriores = areas_pantalla(pantalla, true, anteriores);
+    cantidad_siguientes = areas_pantalla(numero, false, siguientes);
+    ILI9341StartBatch();
+    for (int i = 0; i < cantidad_anteriores; i++)
+    {
+        limpiar_fuera(anteriores[i], siguientes, cantidad_siguientes);
+    }
+    ILI9341EndBatch();
+
+    /* Cada pantalla crea solo los paneles que muestra, los de la anterior vuelven al pool */
+    for (int i = 0; i < PANTALLAS[pantalla].cantidad; i++)
+    {
+        LiberarPanel(widgets[i].panel);
+    }
+    for (int i = 0; i < PANTALLAS[numero].cantidad; i++)
+    {
+        const widget_t *widget = &PANTALLAS[numero].widgets[i];
+
+        widgets[i].celdas = 0;
+        for (const char *formato = widget->formato; *formato; formato++)
+        {
+            widgets[i].celdas += (*formato == '8');
+        }
+        if (widget->texto)
+        {
+            widgets[i].panel = CrearPanelTexto(widget->x, widget->y, widgets[i].celdas, widget->alto, widget->ancho,
+                                               widget->encendido, DIGITO_APAGADO, DIGITO_FONDO);
+        }
+        else
+        {
+            widgets[i].panel = CrearPanelFormato(widget->x, widget->y, widget->formato, widget->separacion,
+                                                 widget->alto, widget->ancho, widget->encendido, DIGITO_APAGADO,
+                                                 DIGITO_FONDO, widget->memoria);
+            UsarCacheDigitos(widgets[i].panel);
+        }
+        widgets[i].dibujado = VALOR_SIN_DIBUJAR;
+        widgets[i].ocultos = 0;
+        widgets[i].encendido = widget->encendido;
+    }
+    pantalla = numero;
+    return true;
+}
+
+/**
+ * @brief Changes the color of the widgets of the screen shown bound to a data source, repainting only their lit
+ * segments. Widgets that already have that color aren't touched.
+ * @param fuente Data source.
+ * @param encendido Color of the lit segments.
+ */
+static void colorear(uint8_t fuente, uint16_t encendido)
+{
+    for (int i = 0; i < PANTALLAS[pantalla].cantidad; i++)
+    {
+        if ((PANTALLAS[pantalla].widgets[i].fuente == fuente) && (widgets[i].encendido != encendido))
+        {
+            ChangeColor(widgets[i].panel, encendido, true);
+            widgets[i].encendido = encendido;
+        }
+    }
+}
+
+/**
+ * @brief Checks if the frame used up its drawing budget.
+ * @param inicio Start of the frame, as returned by `esp_timer_get_time`.
+ * @return true if the frame sent more bytes or windows, or took more time, than allowed.
+ */
+static bool presupuesto_agotado(int64_t inicio)
+{
+    ili9341_stats_t trafico;
+
+    ILI9341GetStats(&trafico);
+    return (trafico.bytes > PRESUPUESTO_BYTES) || (trafico.windows > PRESUPUESTO_VENTANAS) ||
+           (esp_timer_get_time() - inicio > PRESUPUESTO_US);
+}
+
+/**
+ * @brief Draws the characters of a widget of the screen shown on its panel.
+ *
+ * Digit panels get the whole number and text panels the whole string, the library sends only the cells whose
+ * character changed. While a field blinks its cells are drawn one by one, and the hidden ones are erased once.
+ * @param i Position of the widget in the table of the screen.
+ * @param celdas Characters of the cells, from the leftmost one.
+ * @param ocultos Cells hidden by the blink, one bit per cell.
+ */
+static void dibujar_celdas(int i, const uint8_t *celdas, uint16_t ocultos)
+{
+    char texto[MAXIMO_CELDAS + 1];
+    uint32_t numero = 0;
+    bool cifras = true;
+
+    for (int posicion = 0; posicion < widgets[i].celdas; posicion++)
+    {
+        texto[posicion] = (char)celdas[posicion];
+        numero = numero * 10 + celdas[posicion];
+        cifras = cifras && (celdas[posicion] <= 9);
+    }
+    texto[widgets[i].celdas] = '\0';
+
+    /* Las celdas que vuelven a mostrarse quedaron borradas, la biblioteca las dibuja completas */
+    if ((ocultos == 0) && PANTALLAS[pantalla].widgets[i].texto)
+    {
+        DibujarTexto(widgets[i].panel, texto);
+    }
+    else if ((ocultos == 0) && cifras)
+    {
+        DibujarNumero(widgets[i].panel, numero, NUMERO_CEROS);
+    }
+    else
+    {
+        for (int posicion = 0; posicion < widgets[i].celdas; posicion++)
+        {
+            if (!(ocultos & (1 << posicion)))
+            {
+                DibujarDigito(widgets[i].panel, posicion, celdas[posicion]);
+            }
+            else if (!(widgets[i].ocultos & (1 << posicion)))
+            {
+                BorrarDigito(widgets[i].panel, posicion);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Draws the widgets of the screen shown whose value or hidden cells changed since they were drawn.
+ *
+ * Inside a widget only the cells whose character changed are painted. The cells of the field that blinks are erased
+ * once when the field hides, and drawn complete again when it shows. The widgets that can't wait are drawn first,
+ * the low priority ones only while the frame has budget left, the others keep their old value until a later frame.
+ * @param valores Value of each data source.
+ * @param campo_oculto Clock field hidden by the blink, as used by `clock_settings.select`, or -1 if none.
+ * @param inicio Start of the frame, as returned by `esp_timer_get_time`, or 0 to draw everything without budget.
+ * @return true if some widget was left for a later frame.
+ */
+static bool renderizar(const int32_t *valores, int campo_oculto, int64_t inicio)
+{
+    uint8_t celdas[MAXIMO_CELDAS];
+    uint16_t ocultos;
+    bool pendientes = false;
+    int lote = 0;
+
+    for (int orden = 0; orden < 2 * PANTALLAS[pantalla].cantidad; orden++)
+    {
+        /* Primero los widgets que no se pueden diferir y después los demás */
+        int i = orden % PANTALLAS[pantalla].cantidad;
+        const widget_t *widget = &PANTALLAS[pantalla].widgets[i];
+        int32_t valor = valores[widget->fuente];
+
+        if (widget->diferible != (orden >= PANTALLAS[pantalla].cantidad))
+        {
+            continue;
+        }
+
+        ocultos = 0;
+        if ((campo_oculto >= 0) && (CELDAS_CAMPO[campo_oculto].fuente == widget->fuente))
+        {
+            ocultos = ((1 << CELDAS_CAMPO[campo_oculto].cantidad) - 1) << CELDAS_CAMPO[campo_oculto].primero;
+        }
+        if ((valor == widgets[i].dibujado) && (ocultos == widgets[i].ocultos))
+        {
+            continue;
+        }
+        if (widget->diferible && (inicio != 0) && presupuesto_agotado(inicio))
+        {
+            pendientes = true;
+            continue;
+        }
+        if (!lote)
+        {
+            ILI9341StartBatch();
+            lote = 1;
+        }
+
+        if (widget->etiqueta)
+        {
+            copiar_texto(widget->etiqueta, celdas, widgets[i].celdas);
+        }
+        else
+        {
+            widget->formatear(valor, celdas, widgets[i].celdas);
+        }
+        dibujar_celdas(i, celdas, ocultos);
+        widgets[i].dibujado = valor;
+        widgets[i].ocultos = ocultos;
+    }
+    if (lote)
+    {
+        ILI9341EndBatch();
+    }
+    return pendientes;
+}
+
+/**
+ * @brief Copies a clock time to the data sources of the clock screen.
+ * @param valores Value of each data source.
+ * @param reloj Time to show.
+ */
+static void valores_reloj(int32_t *valores, time_clock_t reloj)
+{
+    valores[FUENTE_TIEMPO] = reloj->hr * 10000 + reloj->min * 100 + reloj->sec;
+    valores[FUENTE_DIA] = reloj->day;
+    valores[FUENTE_MES] = reloj->month;
+    valores[FUENTE_YEAR] = reloj->year;
+}
+
+/**
+ * @brief Flashes the alarm inverting the whole screen in the hidden phase of the blink.
+ *
+ * Only a phase change sends a command, the widgets keep being drawn as usual while the screen is inverted.
+ * @param mod Mode of the frame.
+ */
+static void destellar_alarma(int mod)
+{
+    if (invertida != ((mod == MODO_ALARM) && !parpadeo_visible))
+    {
+        invertida = !invertida;
+        ILI9341Invert(invertida);
+    }
+}
+
+/**
+ * @brief Blink timer callback, flips the phase and wakes the display task to repaint the selected field.
+ * @param timer The blink timer.
+ */
+static void alternar_parpadeo(TimerHandle_t timer)
+{
+    (void)timer;
+    parpadeo_visible = !parpadeo_visible;
+    pantalla_notificar();
+}
+
+void pantalla_notificar(void)
+{
+    if (tarea_pantalla != NULL)
+    {
+        xTaskNotifyGive(tarea_pantalla);
+    }
+}
+
+void pantalla_estadisticas(estadisticas_pantalla_t *copia)
+{
+    *copia = estadisticas;
+}
+
+int campo_en_pantalla(uint16_t x, uint16_t y)
+{
+    for (size_t campo = 0; campo < sizeof(CAMPOS_RELOJ) / sizeof(CAMPOS_RELOJ[0]); campo++)
+    {
+        if (x >= CAMPOS_RELOJ[campo].x0 && x <= CAMPOS_RELOJ[campo].x1 &&
+            y >= CAMPOS_RELOJ[campo].y0 && y <= CAMPOS_RELOJ[campo].y1)
+        {
+            return (int)campo;
+        }
+    }
+    return -1;
+}
 
 /**
  * @brief FreeRTOS task to manage and update the display based on different operational modes.
  *
  * This task acts as the central display controller. It receives data from various queues
  * (stopwatch, clock, alarm, configuration) and events from an Event Group to determine
- * which information to display and in what format.
+ * which information to display and in what format. Between updates the task sleeps until
+ * `pantalla_notificar` wakes it, so an idle screen doesn't take any CPU time.
+ *
+ * Each screen is a table of widgets, panels bound to a data source. The task only updates the values of the
+ * sources, and the renderer repaints the widgets whose value changed.
+ *
+ * The task draws at most `CUADROS_POR_SEGUNDO` frames per second, the updates that arrive during a frame period
+ * are drawn together in the next frame. A frame that runs out of budget leaves the low priority widgets for the
+ * next one, so a burst of settings changes can't hold back the stopwatch digits.
  *
  * It supports different display modes:
- * - **Clock Mode:** Shows the current time (hours, minutes, seconds, day, month, year).
+ * - **Clock Mode:** Shows the current time (hours, minutes, seconds, day, month, year). While the analog bit is
+ * set the time is shown with hands on a dial instead, repainting only the pixels the hands leave or cover.
  * - **Clock Configuration Mode:** Allows setting the clock, with the currently selected
  * segment (e.g., hours, minutes) blinking.
- * - **Alarm Mode:** (Currently commented out in the provided code, but structured to display alarm time).
+ * - **Alarm Mode:** Shows the current time while the whole screen flashes, inverting the colors of the LCD on
+ * each phase of the blink timer.
  * - **Alarm Configuration Mode:** Allows setting the alarm time, with the selected segment blinking.
  * - **Stopwatch Mode:** Displays stopwatch time (seconds and tenths of seconds) and
- * up to three partial (lap) times. It also handles resetting the stopwatch display
- * and recording lap times.
+ * up to three partial (lap) times, with the shortest and longest laps in their own colors. It also handles
+ * resetting the stopwatch display and recording lap times. While the statistics bit is set the laps are replaced
+ * by their best, worst, mean, standard deviation and the difference between the last two.
  *  @param args A pointer to a `display_task_t` structure containing all the necessary
  * queue handles, event group handle, and bitmasks for task operation.
  */
 void dibujar_pantalla(void *args)
 {
-    int guardados = 0;
     display_task_t display_arg = (display_task_t)args;
     EventGroupHandle_t _event_group = display_arg->event_group;
     QueueHandle_t queue_crono = display_arg->qcrono;
     QueueHandle_t queue_clock = display_arg->qclock;
     QueueHandle_t alarm_clock = display_arg->qalarm;
     QueueHandle_t qconf = display_arg->qconf;
-    int sel = display_arg->selected;
-    bool set_alarm = display_arg->selected;
-    uint8_t reset_bits = display_arg->reset_bits;
-    uint8_t parcial_bits = display_arg->parcial_bits;
-    uint8_t event_bits = reset_bits | parcial_bits;
-
-    /*Estructura y variables para el cronometro*/
-    time_struct parcial[3] = {
-        {0, 0, 0, 0},
-        {0, 0, 0, 0},
-        {0, 0, 0, 0}};
+    QueueHandle_t queue_vueltas = display_arg->qvueltas;
+    uint8_t cuenta_bits = display_arg->cuenta_bits;
+    uint8_t estadisticas_bits = display_arg->estadisticas_bits;
+    EventBits_t analogico_bits = display_arg->analogico_bits;
+
+    /* Valores de las fuentes que muestran los widgets */
+    int32_t valores[CANTIDAD_FUENTES] = {[FUENTE_VUELTA] = -1};
     time_struct tiempo;
-    int unidad_ant = 0;
-    int decena_ant = 0;
-    int centena_ant = 0;
-    int unidad_act = 0;
-    int decena_act = 0;
-    int centena_act = 0;
-    int decima_ant = 0;
-    int decima_act = 0;
+    vista_vueltas vista = {.mejor = -1, .peor = -1};
 
     /*Estructura para guardar un reloj y alarma*/
     /* clock[0] = reloj, clock[1] = alarma*/
@@ -138,172 +840,205 @@ void dibujar_pantalla(void *args)
         {0, 0, 0, 0, 0, 0},
         {0, 0, 0, 0, 0, 0},
         {0, 0, 0, 0, 0, 0}};
-    time_clock _clock_ant[3] = {
-        {0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0}};
 
-    clock_settings _clock_conf, _clock_conf_ant;
+    clock_settings _clock_conf;
     _clock_conf.t = &(_clock[2]);
     _clock_conf.select = 0;
-    _clock_conf_ant.t = &(_clock_ant[2]);
-    _clock_conf_ant.select = 0;
 
-    clock_settings _alarm, _alarm_ant;
+    clock_settings _alarm;
     _alarm.t = &(_clock[1]);
     _alarm.select = 0;
-    _alarm_ant.t = &(_clock_ant[1]);
-    _alarm_ant.select = 0;
 
-    int clock_select = 0;
-    bool alarm_set = false;
+    /* El campo seleccionado parpadea con un temporizador, sin demorar la tarea entre mensajes */
+    TimerHandle_t parpadeo = xTimerCreate("parpadeo", pdMS_TO_TICKS(PARPADEO_MS), pdTRUE, NULL, alternar_parpadeo);
+    int campo_oculto;
     int mod;
+    bool parpadea;
 
+    tarea_pantalla = xTaskGetCurrentTaskHandle();
     ILI9341Init();
     ILI9341Rotate(ILI9341_Portrait_2);
+    XPT2046Init(NULL); // el táctil usa el bus SPI inicializado por la pantalla
 
-    /*Paneles para el cronómetro*/
-    panel_t segundos = CrearPanel(5, 15, 3, DIGITO_ALTO, DIGITO_ANCHO, DIGITO_ENCENDIDO, DIGITO_APAGADO, DIGITO_FONDO);
-    panel_t decimas = CrearPanel(188, 15, 1, DIGITO_ALTO, DIGITO_ANCHO, DIGITO_ENCENDIDO, DIGITO_APAGADO, DIGITO_FONDO);
-    panel_t parcial1 = CrearPanel(15, 120, 3, DIGITO_ALTO_P, DIGITO_ANCHO_P, DIGITO_ENCENDIDO_R, DIGITO_APAGADO, DIGITO_FONDO);
-    panel_t parcial2 = CrearPanel(47, 180, 3, DIGITO_ALTO_P, DIGITO_ANCHO_P, DIGITO_ENCENDIDO_B, DIGITO_APAGADO, DIGITO_FONDO);
-    panel_t parcial3 = CrearPanel(80, 240, 3, DIGITO_ALTO_P, DIGITO_ANCHO_P, DIGITO_ENCENDIDO_G, DIGITO_APAGADO, DIGITO_FONDO);
-    panel_t parcial1_d = CrearPanel(123, 120, 3, DIGITO_ALTO_P, DIGITO_ANCHO_P, DIGITO_ENCENDIDO_R, DIGITO_APAGADO, DIGITO_FONDO);
-    panel_t parcial2_d = CrearPanel(155, 180, 3, DIGITO_ALTO_P, DIGITO_ANCHO_P, DIGITO_ENCENDIDO_B, DIGITO_APAGADO, DIGITO_FONDO);
-    panel_t parcial3_d = CrearPanel(188, 240, 3, DIGITO_ALTO_P, DIGITO_ANCHO_P, DIGITO_ENCENDIDO_G, DIGITO_APAGADO, DIGITO_FONDO);
-
-    /*Panel para el reloj y alarma*/
-    panel_t rhoras = CrearPanel(5, 15, 2, DIGITO_ALTO_A, DIGITO_ANCHO_A, DIGITO_ENCENDIDO, DIGITO_APAGADO, DIGITO_FONDO);
-    panel_t rminutos = CrearPanel(80, 15, 2, DIGITO_ALTO_A, DIGITO_ANCHO_A, DIGITO_ENCENDIDO, DIGITO_APAGADO, DIGITO_FONDO);
-    panel_t rsegundos = CrearPanel(155, 15, 2, DIGITO_ALTO_A, DIGITO_ANCHO_A, DIGITO_ENCENDIDO, DIGITO_APAGADO, DIGITO_FONDO);
-    panel_t rdia = CrearPanel(15, 120, 2, DIGITO_ALTO_P, DIGITO_ANCHO_P, DIGITO_ENCENDIDO_DG, DIGITO_APAGADO, DIGITO_FONDO);
-    panel_t rmes = CrearPanel(47, 180, 2, DIGITO_ALTO_P, DIGITO_ANCHO_P, DIGITO_ENCENDIDO_DG, DIGITO_APAGADO, DIGITO_FONDO);
-    panel_t ryear = CrearPanel(80, 240, 4, DIGITO_ALTO_P, DIGITO_ANCHO_P, DIGITO_ENCENDIDO_DG, DIGITO_APAGADO, DIGITO_FONDO);
-
-    panel_t estado = CrearPanel(10, 258, 1, DIGITO_ALTO_E, DIGITO_ANCHO_E, DIGITO_ENCENDIDO_Y, DIGITO_APAGADO, DIGITO_FONDO);
-
-    CLOCK_RESET_PANTALLA();
+    for (size_t i = 0; i < sizeof(GEOMETRIAS) / sizeof(GEOMETRIAS[0]); i++)
+    {
+        RegistrarGeometria(&GEOMETRIAS[i]);
+    }
+
+    /* Los cuadros empiezan a lo sumo una vez por periodo, lo que llega entre dos cuadros se dibuja junto */
+    TickType_t periodo = pdMS_TO_TICKS(PERIODO_CUADRO_MS);
+    TickType_t inicio_cuadro, transcurrido;
+    int64_t inicio;
+    uint32_t duracion;
+    bool pendientes;
+    ili9341_stats_t trafico;
+
+    usar_pantalla(PANTALLA_RELOJ);
+    /* Cada tamaño de digito ocupa alrededor de 1 KB de caracteres pre-dibujados, compartidos por sus paneles */
+    ESP_LOGI(TAG, "Caracteres pre-dibujados: %lu bytes", (unsigned long)MemoriaCacheDigitos());
+    /* La esfera se comprime una sola vez, después restaura el fondo debajo de las agujas que se mueven */
+    if (CrearEsfera(ESFERA_X, ESFERA_Y, ESFERA_RADIO, &COLORES_ESFERA))
+    {
+        ESP_LOGI(TAG, "Esfera pre-dibujada: %lu bytes", (unsigned long)MemoriaEsfera());
+    }
     while (1)
     {
-        EventBits_t wBits = xEventGroupWaitBits(_event_group, CAMBIO_MODO | event_bits, pdFALSE, pdFALSE, (TickType_t)1);
+        /* Cada cuadro atiende todo lo que llegó desde el anterior, los buzones guardan solo el último valor */
+        ulTaskNotifyTake(pdTRUE, 0);
+        inicio_cuadro = xTaskGetTickCount();
+        inicio = esp_timer_get_time();
+        EventBits_t wBits = xEventGroupGetBits(_event_group);
+        ILI9341ResetStats();
         mod = (wBits & (MODOS));
-        DibujarDigito(estado, 0, MASCARA_A_POSICION(mod >> 9));
+        valores[FUENTE_MODO] = MASCARA_A_POSICION(mod >> 10);
+        parpadea = (mod == MODO_CLOCK_CONF) || (mod == MODO_ALARM_CONF) || (mod == MODO_ALARM);
+        if (parpadea && !xTimerIsTimerActive(parpadeo))
+        {
+            parpadeo_visible = true;
+            xTimerReset(parpadeo, 0);
+        }
+        else if (!parpadea && xTimerIsTimerActive(parpadeo))
+        {
+            xTimerStop(parpadeo, 0);
+        }
+        campo_oculto = -1;
         switch (wBits & (MODOS))
         {
         case MODO_CLOCK:
             if ((wBits & CAMBIO_MODO) != 0)
             {
-                RESET_CLOCK_ANT_0();
-                CLOCK_RESET_PANTALLA();
+                if (usar_pantalla((wBits & analogico_bits) ? PANTALLA_ANALOGICA : PANTALLA_RELOJ) &&
+                    (pantalla == PANTALLA_ANALOGICA))
+                {
+                    DibujarEsfera();
+                }
                 xEventGroupClearBits(_event_group, CAMBIO_MODO);
             }
-            if (xQueueReceive(queue_clock, &(_clock[0]), (TickType_t)5) == pdPASS)
+            if (xQueueReceive(queue_clock, &(_clock[0]), 0) == pdPASS)
+            {
+                valores_reloj(valores, &(_clock[0]));
+            }
+            /* Las agujas que no cambiaron de posición no se repintan */
+            if (pantalla == PANTALLA_ANALOGICA)
             {
-                DIBUJAR_TODO_RELOJ(_clock[0], _clock_ant[0], rhoras, rminutos, rsegundos, rdia, rmes, ryear);
-                _clock_ant[0] = _clock[0];
+                MoverAgujas(_clock[0].hr, _clock[0].min, _clock[0].sec);
             }
             break;
         case MODO_CLOCK_CONF:
             if ((wBits & CAMBIO_MODO) != 0)
             {
-                RESET_CLOCK_ANT_0();
-                CLOCK_RESET_PANTALLA();
+                usar_pantalla(PANTALLA_RELOJ);
                 xEventGroupClearBits(_event_group, CAMBIO_MODO);
             }
-
-            if (xQueueReceive(qconf, &(_clock_conf), (TickType_t)5) == pdPASS)
+            if (xQueueReceive(qconf, &(_clock_conf), 0) == pdPASS)
             {
-                DIBUJAR_TODO_RELOJ_B(_clock_conf.t, _clock_conf_ant.t, rhoras, rminutos, rsegundos, rdia, rmes, ryear, _clock_conf.select);
-                _clock_conf_ant.t = _clock_conf.t;
+                valores_reloj(valores, _clock_conf.t);
             }
+            campo_oculto = parpadeo_visible ? -1 : _clock_conf.select;
             break;
         case MODO_ALARM:
             if ((wBits & CAMBIO_MODO) != 0)
             {
-                RESET_CLOCK_ANT_0();
-                CLOCK_RESET_PANTALLA();
+                usar_pantalla(PANTALLA_RELOJ);
                 xEventGroupClearBits(_event_group, CAMBIO_MODO);
             }
+            if (xQueueReceive(queue_clock, &(_clock[0]), 0) == pdPASS)
+            {
+                valores_reloj(valores, &(_clock[0]));
+            }
             break;
         case MODO_ALARM_CONF:
             if ((wBits & CAMBIO_MODO) != 0)
             {
-                CLOCK_RESET_PANTALLA();
+                usar_pantalla(PANTALLA_RELOJ);
                 xEventGroupClearBits(_event_group, CAMBIO_MODO);
             }
-
-            if (xQueueReceive(alarm_clock, &(_alarm), (TickType_t)5) == pdPASS)
+            if (xQueueReceive(alarm_clock, &(_alarm), 0) == pdPASS)
             {
-                DIBUJAR_TODO_RELOJ_B(_alarm.t, _alarm_ant.t, rhoras, rminutos, rsegundos, rdia, rmes, ryear, _alarm.select);
-                _alarm_ant.t = _alarm.t;
+                valores_reloj(valores, _alarm.t);
             }
+            campo_oculto = parpadeo_visible ? -1 : _alarm.select;
             break;
         case MODO_CRONO:
             if ((wBits & CAMBIO_MODO) != 0)
             {
-                CRONO_RESET_PANTALLA();
+                usar_pantalla((wBits & estadisticas_bits) ? PANTALLA_ESTADISTICAS : PANTALLA_CRONO);
                 xEventGroupClearBits(_event_group, CAMBIO_MODO);
             }
 
-            if ((wBits & reset_bits) != 0)
+            if (xQueueReceive(queue_crono, &(tiempo), 0) == pdPASS)
             {
-                xEventGroupClearBits(_event_group, reset_bits);
-                DIBUJAR_PARCIAL(parcial1, 0, 0, 0, 0);
-                DIBUJAR_PARCIAL(parcial2, 0, 0, 0, 0);
-                DIBUJAR_PARCIAL(parcial3, 0, 0, 0, 0);
-                guardados = 0;
-                parcial[0].unidad = 0;
-                parcial[0].decena = 0;
-                parcial[0].centena = 0;
-                parcial[0].decima = 0;
-                parcial[1] = parcial[0];
-                parcial[2] = parcial[0];
+                valores[FUENTE_CRONO] = time_decimas(&tiempo);
             }
-            if (xQueueReceive(queue_crono, &(tiempo), (TickType_t)5) == pdPASS)
+            /* Las vueltas y sus estadisticas las lleva el cronometro, la pantalla recibe solo lo que muestra */
+            if (xQueueReceive(queue_vueltas, &(vista), 0) == pdPASS)
             {
-                unidad_act = tiempo.unidad;
-                decena_act = tiempo.decena;
-                centena_act = tiempo.centena;
-                decima_act = tiempo.decima;
-
-                DIBUJAR_SI_CAMBIA(unidad_act, unidad_ant, segundos, 2);
-                DIBUJAR_SI_CAMBIA(decena_act, decena_ant, segundos, 1);
-                DIBUJAR_SI_CAMBIA(centena_act, centena_ant, segundos, 0);
-                DIBUJAR_SI_CAMBIA(decima_act, decima_ant, decimas, 0);
-
-                decima_ant = decima_act;
-                unidad_ant = unidad_act;
-                decena_ant = decena_act;
-                centena_ant = centena_act;
-
-                if ((wBits & parcial_bits) != 0)
+                for (int i = 0; i < VUELTAS_VISIBLES; i++)
                 {
-                    guardados < 3 ? guardados++ : guardados;
-                    int i;
-                    for (i = guardados; i > 1; i--)
-                    {
-                        parcial[i - 1] = parcial[i - 2];
-                    }
-                    parcial[0].unidad = unidad_ant;
-                    parcial[0].decena = decena_ant;
-                    parcial[0].centena = centena_ant;
-                    parcial[0].decima = decima_ant;
-                    xEventGroupClearBits(_event_group, parcial_bits);
-
-                    DIBUJAR_PARCIAL(parcial1, parcial[0].centena,
-                                    parcial[0].decena,
-                                    parcial[0].unidad, parcial[0].decima);
-                    DIBUJAR_PARCIAL(parcial2, parcial[1].centena,
-                                    parcial[1].decena,
-                                    parcial[1].unidad, parcial[1].decima);
-                    DIBUJAR_PARCIAL(parcial3, parcial[2].centena,
-                                    parcial[2].decena,
-                                    parcial[2].unidad, parcial[2].decima);
+                    valores[FUENTE_PARCIAL + i] = time_decimas(&(vista.filas[i]));
                 }
+                valores[FUENTE_VUELTA] = vista.desplazada ? vista.primera : -1;
+                valores[FUENTE_MEJOR] = vista.estadisticas.mejor;
+                valores[FUENTE_PEOR] = vista.estadisticas.peor;
+                valores[FUENTE_MEDIA] = (int32_t)(vista.estadisticas.media + 0.5f);
+                valores[FUENTE_DESVIO] = (int32_t)(sqrtf(vueltas_varianza(&(vista.estadisticas))) + 0.5f);
+                valores[FUENTE_DELTA] = vista.estadisticas.delta;
+                valores[FUENTE_CANTIDAD] = vista.estadisticas.cantidad;
+            }
+
+            /* Los colores se aplican en cada cuadro, los widgets que ya los tienen no se repintan */
+            colorear(FUENTE_CRONO, (wBits & cuenta_bits) ? DIGITO_ENCENDIDO : DIGITO_ENCENDIDO_PAUSA);
+            for (int i = 0; i < VUELTAS_VISIBLES; i++)
+            {
+                colorear(FUENTE_PARCIAL + i, (i == vista.mejor)  ? DIGITO_ENCENDIDO_MEJOR
+                                             : (i == vista.peor) ? DIGITO_ENCENDIDO_PEOR
+                                                                 : DIGITO_ENCENDIDO_VUELTA);
             }
             break;
         default:
             break;
         }
+
+        /* La alarma destella invirtiendo toda la pantalla, un comando por fase en lugar de repintarla */
+        destellar_alarma(mod);
+
+        /* Los cambios de modo redibujan toda la pantalla, esos cuadros no tienen presupuesto */
+        pendientes = renderizar(valores, campo_oculto, ((wBits & CAMBIO_MODO) != 0) ? 0 : inicio);
+
+        duracion = (uint32_t)(esp_timer_get_time() - inicio);
+        ILI9341GetStats(&trafico);
+        estadisticas.cuadros++;
+        estadisticas.tiempo_total_us += duracion;
+        if (duracion > estadisticas.tiempo_maximo_us)
+        {
+            estadisticas.tiempo_maximo_us = duracion;
+        }
+        if (pendientes)
+        {
+            estadisticas.diferidos++;
+        }
+        if (((wBits & CAMBIO_MODO) == 0) && ((trafico.bytes > PRESUPUESTO_BYTES) ||
+                                             (trafico.windows > PRESUPUESTO_VENTANAS) || (duracion > PRESUPUESTO_US)))
+        {
+            estadisticas.excedidos++;
+            /* La consola es lenta, solo se avisa en el primer cuadro excedido y cada vez que la cuenta se duplica */
+            if ((estadisticas.excedidos & (estadisticas.excedidos - 1)) == 0)
+            {
+                ESP_LOGW(TAG, "%lu cuadros fuera de presupuesto, el último: %lu bytes, %lu ventanas, %lu us",
+                         (unsigned long)estadisticas.excedidos, (unsigned long)trafico.bytes,
+                         (unsigned long)trafico.windows, (unsigned long)duracion);
+            }
+        }
+
+        /* Sin mensajes ni cambios de estado la tarea no vuelve a correr, salvo que queden widgets diferidos */
+        if (!pendientes)
+        {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+        transcurrido = xTaskGetTickCount() - inicio_cuadro;
+        if (transcurrido < periodo)
+        {
+            vTaskDelay(periodo - transcurrido);
+        }
     }
 }
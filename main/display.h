@@ -17,261 +17,80 @@
 #define DIGITO_ALTO_A 60  /**< Height for alarm/clock digits. */
 #define DIGITO_ANCHO_P 30 /**< Width for partial/small digits. */
 #define DIGITO_ALTO_P 50  /**< Height for partial/small digits. */
-#define DIGITO_ANCHO_E 15 /**< Width for mode indicator digits. */
-#define DIGITO_ALTO_E 30  /**< Height for mode indicator digits. */
+#define DIGITO_ANCHO_E 22 /**< Width for mode indicator characters. */
+#define DIGITO_ALTO_E 30  /**< Height for mode indicator characters. */
 /** @} */
-
 /**
- * @name Digit Display Colors
- * @brief Constants defining the colors for various display elements.
+ * @name Separator Columns
+ * @brief Width of the columns left for the separators built into the panels.
  * @{
  */
-#define DIGITO_ENCENDIDO ILI9341_WHITE       /**< Default color for active segments of digits. */
-#define DIGITO_ENCENDIDO_G ILI9341_GREEN     /**< Green color for active segments. */
-#define DIGITO_ENCENDIDO_R ILI9341_RED       /**< Red color for active segments. */
-#define DIGITO_ENCENDIDO_B ILI9341_BLUE      /**< Blue color for active segments. */
-#define DIGITO_ENCENDIDO_Y ILI9341_YELLOW    /**< Yellow color for active segments. */
-#define DIGITO_ENCENDIDO_DG ILI9341_DARKGREY /**< Dark grey color for active segments. */
-#define DIGITO_APAGADO 0x3800                /**< Color for inactive segments of digits (a shade of dark green/brown). */
-#define DIGITO_FONDO ILI9341_BLACK           /**< Background color of the display. */
+#define SEPARACION_PUNTO 18      /**< Decimal point of the stopwatch and lap times. */
+#define SEPARACION_DOS_PUNTOS 15 /**< Colon between the clock fields. */
 /** @} */
-
-/**
- * @brief Macro to draw a digit only if its value has changed.
- * @param actual The current digit value.
- * @param anterior The previous digit value.
- * @param panel The display panel structure.
- * @param posicion The position within the panel to draw the digit.
- */
-#define DIBUJAR_SI_CAMBIA(actual, anterior, panel, posicion) \
-    if (actual != anterior)                                  \
-    {                                                        \
-        DibujarDigito(panel, posicion, actual);              \
-    }
-
 /**
- * @name Number Extraction Macros
- * @brief Macros for extracting individual digits (thousands, hundreds, tens, units) from a number.
+ * @name Drawing Budget
+ * @brief Work allowed to a frame of the display task that doesn't change the screen. The worst stopwatch frame,
+ * a tenth that carries to the hundreds while it's recolored, sends about 21 KB in 40 windows. When a frame runs
+ * out of budget the low priority widgets are left for the next one.
  * @{
  */
-#define EXTRAER_MILES(n) ((n) / 1000)   /**< Extracts the thousands digit. */
-#define RESTO_MILES(n) ((n) % 1000)     /**< Gets the remainder after extracting thousands. */
-#define EXTRAER_CENTENAS(n) ((n) / 100) /**< Extracts the hundreds digit. */
-#define RESTO_CENTENAS(n) ((n) % 100)   /**< Gets the remainder after extracting hundreds. */
-#define EXTRAER_DECENAS(n) ((n) / 10)   /**< Extracts the tens digit. */
-#define EXTRAER_UNIDADES(n) ((n) % 10)  /**< Extracts the units digit. */
+#define PRESUPUESTO_BYTES 24576 /**< Data bytes sent to the LCD. */
+#define PRESUPUESTO_VENTANAS 64 /**< Address windows set on the LCD. */
+#define PRESUPUESTO_US 30000    /**< Time spent drawing, in microseconds. */
 /** @} */
-
-/**
- * @brief Macro to draw a 4-digit year on a display panel.
- * @param panel_base The base panel for drawing digits.
- * @param year_ac The current year value.
- * @param year_ant The previous year value (not directly used by this macro, but kept for consistency).
- */
-#define DIBUJAR_YEAR(panel_base, year_ac, year_ant)                            \
-    {                                                                          \
-        int miles = EXTRAER_MILES(year_ac);                                    \
-        int centenas = EXTRAER_CENTENAS(RESTO_MILES(year_ac));                 \
-        int decenas = EXTRAER_DECENAS(RESTO_CENTENAS(RESTO_MILES(year_ac)));   \
-        int unidades = EXTRAER_UNIDADES(RESTO_CENTENAS(RESTO_MILES(year_ac))); \
-        _DIBUJAR_YEAR(panel_base, miles, centenas, decenas, unidades);         \
-    }
-
-#define DIBUJAR_YEAR_B(panel_base, year_ac, year_ant)                          \
-    {                                                                          \
-        int miles = EXTRAER_MILES(year_ac);                                    \
-        int centenas = EXTRAER_CENTENAS(RESTO_MILES(year_ac));                 \
-        int decenas = EXTRAER_DECENAS(RESTO_CENTENAS(RESTO_MILES(year_ac)));   \
-        int unidades = EXTRAER_UNIDADES(RESTO_CENTENAS(RESTO_MILES(year_ac))); \
-        _DIBUJAR_YEAR_B(panel_base, miles, centenas, decenas, unidades);       \
-    }
-
-/**
- * @brief Internal macro to draw individual year digits.
- * @param panel_base The base panel for drawing digits.
- * @param mil The thousands digit.
- * @param centena The hundreds digit.
- * @param decena The tens digit.
- * @param unidad The units digit.
- */
-#define _DIBUJAR_YEAR(panel_base, mil, centena, decena, unidad) \
-    DibujarDigito(panel_base, 3, unidad);                       \
-    DibujarDigito(panel_base, 2, decena);                       \
-    DibujarDigito(panel_base, 1, centena);                      \
-    DibujarDigito(panel_base, 0, mil);
-
-#define _DIBUJAR_YEAR_B(panel_base, mil, centena, decena, unidad) \
-    for (int i = 0; i < 1; ++i)                                   \
-    {                                                             \
-        BorrarDigito(panel_base, 3);                              \
-        BorrarDigito(panel_base, 2);                              \
-        BorrarDigito(panel_base, 1);                              \
-        BorrarDigito(panel_base, 0);                              \
-        vTaskDelay(pdMS_TO_TICKS(50));                            \
-        DibujarDigito(panel_base, 3, unidad);                     \
-        DibujarDigito(panel_base, 2, decena);                     \
-        DibujarDigito(panel_base, 1, centena);                    \
-        DibujarDigito(panel_base, 0, mil);                        \
-    }
-/**
- * @brief Macro to draw a 2-digit hour on a display panel.
- * @param panel_base The base panel for drawing digits.
- * @param hora_ac The current hour value.
- * @param hora_ant The previous hour value (not directly used by this macro, but kept for consistency).
- */
-#define DIBUJAR_HORA(panel_base, hora_ac, hora_ant) \
-    {                                               \
-        DIBUJAR_T(panel_base, hora_ac / 10, hora_ac % 10)}
-
-#define DIBUJAR_HORA_B(panel_base, hora_ac, hora_ant)     \
-    for (int i = 0; i < 1; ++i)                           \
-    {                                                     \
-        BorrarDigito(panel_base, 1);                      \
-        BorrarDigito(panel_base, 0);                      \
-        vTaskDelay(pdMS_TO_TICKS(50));                    \
-        DIBUJAR_T(panel_base, hora_ac / 10, hora_ac % 10) \
-    }
-
-/**
- * @brief Macro to draw a 2-digit month on a display panel.
- * @param panel_base The base panel for drawing digits.
- * @param mes_ac The current month value.
- * @param mes_ant The previous month value
- **/
-
-// Podría mos cambiarla para mostrar las 3 primeras letras del mes
-#define DIBUJAR_MES(panel_base, mes_ac, mes_ant) \
-    {                                            \
-        DIBUJAR_T(panel_base, mes_ac / 10, mes_ac % 10)}
-
-/**
- * @brief Macro to draw a 2-digit month with a blinking effect.
- * @param panel_base The base panel for drawing digits.
- * @param mes_ac The current month value.
- * @param mes_ant The previous month value
- */
-#define DIBUJAR_MES_B(panel_base, mes_ac, mes_ant)      \
-    for (int i = 0; i < 1; ++i)                         \
-    {                                                   \
-        BorrarDigito(panel_base, 1);                    \
-        BorrarDigito(panel_base, 0);                    \
-        vTaskDelay(pdMS_TO_TICKS(50));                  \
-        DIBUJAR_T(panel_base, mes_ac / 10, mes_ac % 10) \
-    }
-
 /**
- * @brief Internal macro to draw a 2-digit number (tens and units).
- * @param panel_base The base panel for drawing digits.
- * @param decena The tens digit.
- * @param unidad The units digit.
+ * @name Frame Pacing
+ * @brief The display task draws at most one frame per period, the updates that arrive in between are drawn
+ * together in the next frame.
+ * @{
  */
-#define DIBUJAR_T(panel_base, decena, unidad) \
-    DibujarDigito(panel_base, 1, unidad);     \
-    DibujarDigito(panel_base, 0, decena);
+#define CUADROS_POR_SEGUNDO 20                         /**< Highest frame rate. */
+#define PERIODO_CUADRO_MS (1000 / CUADROS_POR_SEGUNDO) /**< Shortest time between the start of two frames. */
+/** @} */
 
 /**
- * @brief Macro to draw the entire clock display.
- * @param _clock_act The current clock time (`time_clock` struct).
- * @param _clock_ant The previous clock time (`time_clock` struct).
- * @param h Panel for hours.
- * @param m Panel for minutes.
- * @param s Panel for seconds.
- * @param d Panel for day.
- * @param mes Panel for month.
- * @param a Panel for year.
+ * @name Analog Dial
+ * @brief Position and size of the dial of the clock with hands.
+ * @{
  */
-#define DIBUJAR_TODO_RELOJ(_clock_act, _clock_ant, h, m, s, d, mes, a) \
-    do                                                                 \
-    {                                                                  \
-        DIBUJAR_HORA(h, _clock_act.hr, _clock_ant.hr);                 \
-        DIBUJAR_HORA(m, _clock_act.min, _clock_ant.min);               \
-        DIBUJAR_HORA(s, _clock_act.sec, _clock_ant.sec);               \
-        DIBUJAR_HORA(d, _clock_act.day, _clock_ant.day);               \
-        DIBUJAR_MES(mes, _clock_act.month, _clock_ant.month);          \
-        DIBUJAR_YEAR(a, _clock_act.year, _clock_ant.year);             \
-    } while (0)
+#define ESFERA_X 120     /**< Horizontal position of the center. */
+#define ESFERA_Y 130     /**< Vertical position of the center. */
+#define ESFERA_RADIO 110 /**< Radius in pixels. */
+/** @} */
 
+#define PARPADEO_MS 400 /**< Time the field selected in the settings modes stays shown or hidden, and the screen
+                           stays inverted or not while the alarm sounds. */
 /**
- * @brief Macro to draw the entire clock display with a selected blinking segment.
- * @param _clock_act The current clock time (`time_clock` struct).
- * @param _clock_ant The previous clock time (`time_clock` struct).
- * @param h Panel for hours.
- * @param m Panel for minutes.
- * @param s Panel for seconds.
- * @param d Panel for day.
- * @param mes Panel for month.
- * @param a Panel for year.
- * @param sel The index of the segment to blink (0 for hours, 1 for minutes, etc.).
+ * @name Digit Geometries
+ * @brief Segment geometry of each digit size, computed at compile time and shared by the panels of that size.
+ * @{
  */
-#define DIBUJAR_TODO_RELOJ_A(_clock_act, _clock_ant, h, m, s, d, mes, a, sel) \
-    do                                                                        \
-    {                                                                         \
-        if (sel == 0)                                                         \
-            DIBUJAR_HORA_B(h, _clock_act.hr, _clock_ant.hr)                   \
-        else                                                                  \
-            DIBUJAR_HORA(h, _clock_act.hr, _clock_ant.hr);                    \
-        if (sel == 1)                                                         \
-            DIBUJAR_HORA_B(m, _clock_act.min, _clock_ant.min)                 \
-        else                                                                  \
-            DIBUJAR_HORA(m, _clock_act.min, _clock_ant.min);                  \
-        if (sel == 2)                                                         \
-            DIBUJAR_HORA_B(s, _clock_act.sec, _clock_ant.sec)                 \
-        else                                                                  \
-            DIBUJAR_HORA(s, _clock_act.sec, _clock_ant.sec);                  \
-        if (sel == 3)                                                         \
-            DIBUJAR_HORA_B(d, _clock_act.day, _clock_ant.day)                 \
-        else                                                                  \
-            DIBUJAR_HORA(d, _clock_act.day, _clock_ant.day);                  \
-        if (sel == 4)                                                         \
-            DIBUJAR_MES_B(mes, _clock_act.month, _clock_ant.month)            \
-        else                                                                  \
-            DIBUJAR_MES(mes, _clock_act.month, _clock_ant.month);             \
-        if (sel == 5)                                                         \
-            DIBUJAR_YEAR_B(a, _clock_act.year, _clock_ant.year);              \
-        else                                                                  \
-            DIBUJAR_YEAR(a, _clock_act.year, _clock_ant.year);                \
-    } while (0)
+#define GEOMETRIA_DIGITO GEOMETRIA_7SEG(DIGITO_ALTO, DIGITO_ANCHO)       /**< Large digits. */
+#define GEOMETRIA_DIGITO_A GEOMETRIA_7SEG(DIGITO_ALTO_A, DIGITO_ANCHO_A) /**< Clock digits. */
+#define GEOMETRIA_DIGITO_P GEOMETRIA_7SEG(DIGITO_ALTO_P, DIGITO_ANCHO_P) /**< Small digits. */
+#define GEOMETRIA_TEXTO_P GEOMETRIA_14SEG(DIGITO_ALTO_P, DIGITO_ANCHO_P) /**< Month names. */
+#define GEOMETRIA_TEXTO_E GEOMETRIA_14SEG(DIGITO_ALTO_E, DIGITO_ANCHO_E) /**< Mode names. */
+/** @} */
 
 /**
- * @brief Macro to draw the entire clock display for alarm configuration  and clock configutarion with a selected blinking segment.
- * @param _clock_act Pointer to the current alarm time (`time_clock` struct).
- * @param _clock_ant Pointer to the previous alarm time (`time_clock` struct).
- * @param h Panel for hours.
- * @param m Panel for minutes.
- * @param s Panel for seconds.
- * @param d Panel for day.
- * @param mes Panel for month.
- * @param a Panel for year.
- * @param sel The index of the segment to blink (0 for hours, 1 for minutes, etc.).
+ * @name Digit Display Colors
+ * @brief Constants defining the colors for various display elements.
+ * @{
  */
-#define DIBUJAR_TODO_RELOJ_B(_clock_act, _clock_ant, h, m, s, d, mes, a, sel) \
-    do                                                                        \
-    {                                                                         \
-        if (sel == 0)                                                         \
-            DIBUJAR_HORA_B(h, _clock_act->hr, _clock_ant->hr)                 \
-        else                                                                  \
-            DIBUJAR_HORA(h, _clock_act->hr, _clock_ant->hr);                  \
-        if (sel == 1)                                                         \
-            DIBUJAR_HORA_B(m, _clock_act->min, _clock_ant->min)               \
-        else                                                                  \
-            DIBUJAR_HORA(m, _clock_act->min, _clock_ant->min)                 \
-        if (sel == 2)                                                         \
-            DIBUJAR_HORA_B(s, _clock_act->sec, _clock_ant->sec)               \
-        else                                                                  \
-            DIBUJAR_HORA(s, _clock_act->sec, _clock_ant->sec)                 \
-        if (sel == 3)                                                         \
-            DIBUJAR_HORA_B(d, _clock_act->day, _clock_ant->day)               \
-        else                                                                  \
-            DIBUJAR_HORA(d, _clock_act->day, _clock_ant->day);                \
-        if (sel == 4)                                                         \
-            DIBUJAR_MES_B(mes, _clock_act->month, _clock_ant->month)          \
-        else                                                                  \
-            DIBUJAR_MES(mes, _clock_act->month, _clock_ant->month);           \
-        if (sel == 5)                                                         \
-            DIBUJAR_YEAR_B(a, _clock_act->year, _clock_ant->year)             \
-        else                                                                  \
-            DIBUJAR_YEAR(a, _clock_act->year, _clock_ant->year);              \
-    } while (0)
+#define DIGITO_ENCENDIDO ILI9341_WHITE        /**< Default color for active segments of digits. */
+#define DIGITO_ENCENDIDO_G ILI9341_GREEN      /**< Green color for active segments. */
+#define DIGITO_ENCENDIDO_R ILI9341_RED        /**< Red color for active segments. */
+#define DIGITO_ENCENDIDO_B ILI9341_BLUE       /**< Blue color for active segments. */
+#define DIGITO_ENCENDIDO_Y ILI9341_YELLOW     /**< Yellow color for active segments. */
+#define DIGITO_ENCENDIDO_DG ILI9341_DARKGREY  /**< Dark grey color for active segments. */
+#define DIGITO_ENCENDIDO_PAUSA ILI9341_ORANGE /**< Color of the stopwatch while it is paused. */
+#define DIGITO_ENCENDIDO_VUELTA ILI9341_CYAN  /**< Color of the lap times. */
+#define DIGITO_ENCENDIDO_MEJOR ILI9341_GREEN  /**< Color of the shortest lap. */
+#define DIGITO_ENCENDIDO_PEOR ILI9341_RED     /**< Color of the longest lap. */
+#define DIGITO_APAGADO 0x3800                 /**< Color for inactive segments of digits (a shade of dark green/brown). */
+#define DIGITO_FONDO ILI9341_BLACK            /**< Background color of the display. */
+/** @} */
 
 /**
  * @brief Converts a bitmask (power of 2) to its corresponding position (0-indexed).
@@ -289,16 +108,21 @@
 
 /**
  * @brief Structure to hold parameters for the display task.
+ *
+ * The mailboxes are queues with a single slot written with `xQueueOverwrite`, the producers never wait and the
+ * display always draws the newest value.
  */
 typedef struct display_task
 {
-    QueueHandle_t qcrono;           /**< Queue handle for stopwatch time data. */
-    QueueHandle_t qclock;           /**< Queue handle for current clock time data. */
-    QueueHandle_t qalarm;           /**< Queue handle for alarm time configuration data. */
-    QueueHandle_t qconf;            /**< Queue handle for clock configuration data  */
+    QueueHandle_t qcrono;           /**< Mailbox for stopwatch time data. */
+    QueueHandle_t qclock;           /**< Mailbox for current clock time data. */
+    QueueHandle_t qalarm;           /**< Mailbox for alarm time configuration data. */
+    QueueHandle_t qconf;            /**< Mailbox for clock configuration data. */
+    QueueHandle_t qvueltas;         /**< Mailbox for the window of lap times shown. */
     EventGroupHandle_t event_group; /**< Event group for mode changes and display specific events. */
-    uint8_t parcial_bits;           /**< Event bitmask for triggering partial (lap) time display. */
-    uint32_t reset_bits;            /**< Event bitmask for triggering a display reset. */
+    uint8_t cuenta_bits;            /**< Event bitmask set while the stopwatch is running. */
+    uint8_t estadisticas_bits;      /**< Event bitmask set while the lap statistics are shown instead of the laps. */
+    EventBits_t analogico_bits;     /**< Event bitmask set while the clock is shown with hands instead of digits. */
     int selected;                   /**< Initial selected item for display configuration. */
 } display_task;
 
@@ -307,6 +131,44 @@ typedef struct display_task
  */
 typedef struct display_task *display_task_t;
 
+/**
+ * @brief Frame statistics of the display task, accumulated since it started.
+ */
+typedef struct
+{
+    uint32_t cuadros;          /**< Frames drawn. */
+    uint32_t excedidos;        /**< Frames, other than screen changes, that went over the budget. */
+    uint32_t diferidos;        /**< Frames that left low priority widgets for the next one. */
+    uint32_t tiempo_maximo_us; /**< Longest frame, in microseconds. */
+    uint64_t tiempo_total_us;  /**< Sum of the frame times, in microseconds, for the average. */
+} estadisticas_pantalla_t;
+
 void dibujar_pantalla(void *args);
 
+/**
+ * @brief Finds the clock field drawn at a point of the screen, used to select fields by touch.
+ * @param x Horizontal position in pixels.
+ * @param y Vertical position in pixels.
+ * @return The field index as used by `clock_settings.select` (0=hr, 1=min, 2=sec, 3=day, 4=month, 5=year),
+ * or -1 if there is no field at that point.
+ */
+int campo_en_pantalla(uint16_t x, uint16_t y);
+
+/**
+ * @brief Wakes the display task, which sleeps until there is something new to draw.
+ *
+ * Must be called after overwriting any of the display mailboxes and after changing the VER_ESTADISTICAS,
+ * VER_ANALOGICO or CAMBIO_MODO bits, which are the only ones the task reads besides the mode. Calls made before the
+ * display task starts are ignored, the task draws the current state when it starts.
+ */
+void pantalla_notificar(void);
+
+/**
+ * @brief Copies the frame statistics of the display task.
+ *
+ * The copy isn't synchronized with the task, a field may already include a frame the others don't.
+ * @param estadisticas Where the statistics are copied.
+ */
+void pantalla_estadisticas(estadisticas_pantalla_t *estadisticas);
+
 #endif
\ No newline at end of file
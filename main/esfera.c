@@ -0,0 +1,411 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+
+/** @file esfera.c
+ ** @brief Definiciones de la biblioteca para dibujar un reloj de agujas en una pantalla TFT
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "esfera.h"
+#include "ili9341.h"
+#include <math.h>
+#include <string.h>
+
+/* === Macros definitions ========================================================================================== */
+
+#define LADO_MAXIMO (2 * RADIO_MAXIMO_ESFERA + 1) //!< Filas y columnas del cuadrado de la esfera más grande
+
+#define COLOR_FONDO    0 //!< Indice en las corridas del color alrededor de la esfera
+#define COLOR_ESFERA   1 //!< Indice en las corridas del color de la esfera
+#define COLOR_BORDE    2 //!< Indice en las corridas del color del borde
+#define COLOR_MINUTOS  3 //!< Indice en las corridas del color de las marcas de los minutos
+#define COLOR_HORAS    4 //!< Indice en las corridas del color de las marcas de las horas
+#define CANTIDAD_COLORES 5 //!< Cantidad de colores de las corridas
+
+#define CORRIDA(color, longitud)  ((uint8_t)(((color) << 5) | ((longitud)-1))) //!< Byte que codifica una corrida
+#define CORRIDA_COLOR(corrida)    ((corrida) >> 5)                            //!< Indice del color de una corrida
+#define CORRIDA_LONGITUD(corrida) (((corrida)&0x1F) + 1)                      //!< Cantidad de pixeles de una corrida
+#define LONGITUD_MAXIMA           32 //!< Pixeles de la corrida más larga, las más largas se parten
+
+#define AGUJA_HORA     0 //!< Aguja de las horas, se dibuja primero
+#define AGUJA_MINUTO   1 //!< Aguja de los minutos
+#define AGUJA_SEGUNDO  2 //!< Aguja de los segundos, se dibuja por encima de las otras
+#define CANTIDAD_AGUJAS 3 //!< Cantidad de agujas del reloj
+
+#define SIN_POSICION -1 //!< Posición de una aguja que no se dibujó
+#define ANCHO_BORDE  3  //!< Ancho en pixeles del borde de la esfera
+#define RADIO_CENTRO 4  //!< Radio en pixeles del circulo que cubre el eje de las agujas
+#define COSTO_VENTANA 32 //!< Pixeles que se podrian enviar en el tiempo que lleva abrir una ventana en la pantalla
+
+/* === Private data type declarations ============================================================================== */
+
+/**
+ * @brief Forma de una aguja, proporcional al radio de la esfera
+ *
+ * La aguja es un rombo alargado con un extremo en la punta, el opuesto en la cola del otro lado del eje y los otros
+ * dos a los costados del eje.
+ */
+struct forma_aguja_s {
+    uint16_t posiciones; //!< Posiciones de la aguja en una vuelta completa
+    uint8_t largo;       //!< Distancia del eje a la punta, en centésimos del radio
+    uint8_t cola;        //!< Distancia del eje a la cola, en centésimos del radio
+    float ancho;         //!< Distancia del eje a los costados, en pixeles
+};
+
+/**
+ * @brief Aguja del reloj con los tramos que ocupa en cada fila
+ */
+struct aguja_s {
+    int16_t posicion;                //!< Posición dibujada, @ref SIN_POSICION si la aguja no tiene tramos
+    int16_t primera;                 //!< Fila de la esfera del primer tramo
+    int16_t filas;                   //!< Cantidad de filas con tramos
+    int16_t izquierda[LADO_MAXIMO];  //!< Primera columna de la aguja en cada fila, mayor que la última si no la toca
+    int16_t derecha[LADO_MAXIMO];    //!< Última columna de la aguja en cada fila
+};
+
+/* === Private function declarations =============================================================================== */
+
+/* === Public variable definitions ================================================================================= */
+
+/* === Private variable definitions ================================================================================ */
+
+//! @brief Formas de las agujas, en el orden en que se dibujan
+static const struct forma_aguja_s FORMAS[CANTIDAD_AGUJAS] = {
+    [AGUJA_HORA] = {720, 50, 10, 4.0f},
+    [AGUJA_MINUTO] = {60, 75, 12, 3.0f},
+    [AGUJA_SEGUNDO] = {60, 85, 15, 1.0f},
+};
+
+static struct {
+    uint16_t x;                          //!< Columna de la pantalla del borde izquierdo del cuadrado de la esfera
+    uint16_t y;                          //!< Fila de la pantalla del borde superior del cuadrado de la esfera
+    uint16_t radio;                      //!< Radio de la esfera, cero si no fue creada
+    uint16_t lado;                       //!< Filas y columnas del cuadrado que ocupa la esfera
+    const colores_esfera_t * colores;    //!< Colores de la esfera y de las agujas
+    uint16_t paleta[CANTIDAD_COLORES];   //!< Color de cada indice de las corridas
+    uint16_t inicio[LADO_MAXIMO + 1];    //!< Posición de la primera corrida de cada fila, y del final de la última
+} esfera;
+
+static uint8_t corridas[MEMORIA_ESFERA];        //!< Esfera pre-dibujada, corridas de cada fila de izquierda a derecha
+static struct aguja_s agujas[CANTIDAD_AGUJAS];  //!< Agujas en la posición dibujada
+static struct aguja_s anterior;                 //!< Tramos de una aguja antes de moverla
+static int16_t sucia_desde[LADO_MAXIMO];        //!< Primera columna que hay que repintar en cada fila
+static int16_t sucia_hasta[LADO_MAXIMO];        //!< Última columna que hay que repintar en cada fila
+static uint16_t linea[LADO_MAXIMO];             //!< Colores de una fila compuesta antes de enviarla
+
+/* === Private function definitions ================================================================================ */
+
+static int Menor(int a, int b) {
+    return a < b ? a : b;
+}
+
+static int Mayor(int a, int b) {
+    return a > b ? a : b;
+}
+
+static uint8_t ColorEsfera(int dx, int dy) {
+    float distancia = sqrtf(dx * dx + dy * dy);
+    float angulo, a_lo_largo, de_costado;
+    int marca, horas;
+
+    if (distancia > esfera.radio + 0.5f) {
+        return COLOR_FONDO;
+    }
+    if (distancia > esfera.radio - ANCHO_BORDE + 0.5f) {
+        return COLOR_BORDE;
+    }
+
+    // Solo la marca más cercana al angulo del pixel puede cubrirlo
+    marca = (int)lroundf(atan2f(dx, -dy) * 30 / (float)M_PI);
+    horas = ((marca % 5) == 0);
+    angulo = marca * (float)M_PI / 30;
+    a_lo_largo = dx * sinf(angulo) - dy * cosf(angulo);
+    de_costado = fabsf(dx * cosf(angulo) + dy * sinf(angulo));
+    if ((a_lo_largo < esfera.radio - ANCHO_BORDE) && (de_costado <= (horas ? 1.5f : 0.5f)) &&
+        (a_lo_largo >= esfera.radio - ANCHO_BORDE - esfera.radio * (horas ? 14 : 6) / 100)) {
+        return horas ? COLOR_HORAS : COLOR_MINUTOS;
+    }
+    return COLOR_ESFERA;
+}
+
+static void CalcularTramos(struct aguja_s * aguja, const struct forma_aguja_s * forma) {
+    float angulo = 2 * (float)M_PI * aguja->posicion / forma->posiciones;
+    float ux = sinf(angulo), uy = -cosf(angulo);
+    float px[4], py[4], desde, hasta, x;
+    int primera, ultima;
+
+    // Cola, costado izquierdo, punta y costado derecho, con el eje en el centro del cuadrado
+    px[0] = esfera.radio - ux * esfera.radio * forma->cola / 100;
+    py[0] = esfera.radio - uy * esfera.radio * forma->cola / 100;
+    px[1] = esfera.radio - uy * forma->ancho;
+    py[1] = esfera.radio + ux * forma->ancho;
+    px[2] = esfera.radio + ux * esfera.radio * forma->largo / 100;
+    py[2] = esfera.radio + uy * esfera.radio * forma->largo / 100;
+    px[3] = esfera.radio + uy * forma->ancho;
+    py[3] = esfera.radio - ux * forma->ancho;
+
+    primera = (int)ceilf(fminf(fminf(py[0], py[1]), fminf(py[2], py[3])));
+    ultima = (int)floorf(fmaxf(fmaxf(py[0], py[1]), fmaxf(py[2], py[3])));
+    primera = Mayor(primera, 0);
+    ultima = Menor(ultima, esfera.lado - 1);
+    aguja->primera = primera;
+    aguja->filas = Mayor(ultima - primera + 1, 0);
+
+    for (int fila = 0; fila < aguja->filas; fila++) {
+        // El rombo es convexo, cada fila lo corta en un solo tramo entre los cruces con sus lados
+        desde = esfera.lado;
+        hasta = -1;
+        for (int lado = 0; lado < 4; lado++) {
+            int siguiente = (lado + 1) % 4;
+            float y = primera + fila;
+
+            if ((py[lado] <= y) != (py[siguiente] <= y)) {
+                x = px[lado] + (y - py[lado]) * (px[siguiente] - px[lado]) / (py[siguiente] - py[lado]);
+                desde = fminf(desde, x);
+                hasta = fmaxf(hasta, x);
+            }
+        }
+        if (hasta < desde) {
+            aguja->izquierda[fila] = 1;
+            aguja->derecha[fila] = 0;
+        } else if (ceilf(desde) > floorf(hasta)) {
+            // Un tramo más angosto que un pixel se dibuja en el pixel más cercano, así la aguja no se corta
+            aguja->izquierda[fila] = (int16_t)lroundf((desde + hasta) / 2);
+            aguja->derecha[fila] = aguja->izquierda[fila];
+        } else {
+            aguja->izquierda[fila] = (int16_t)ceilf(desde);
+            aguja->derecha[fila] = (int16_t)floorf(hasta);
+        }
+    }
+}
+
+static void MarcarColumnas(int fila, int desde, int hasta) {
+    if (desde <= hasta) {
+        sucia_desde[fila] = Menor(sucia_desde[fila], desde);
+        sucia_hasta[fila] = Mayor(sucia_hasta[fila], hasta);
+    }
+}
+
+static int TramoAguja(const struct aguja_s * aguja, int fila, int * desde, int * hasta) {
+    if ((fila < aguja->primera) || (fila >= aguja->primera + aguja->filas)) {
+        return 0;
+    }
+    *desde = aguja->izquierda[fila - aguja->primera];
+    *hasta = aguja->derecha[fila - aguja->primera];
+    return *desde <= *hasta;
+}
+
+static void MarcarDiferencias(const struct aguja_s * antes, const struct aguja_s * despues) {
+    int a, b, c, d, habia, hay;
+
+    for (int fila = 0; fila < esfera.lado; fila++) {
+        habia = TramoAguja(antes, fila, &a, &b);
+        hay = TramoAguja(despues, fila, &c, &d);
+        if (habia && hay && (b >= c) && (d >= a)) {
+            // Los tramos se superponen, solo cambian los pixeles de los extremos
+            MarcarColumnas(fila, Menor(a, c), Mayor(a, c) - 1);
+            MarcarColumnas(fila, Menor(b, d) + 1, Mayor(b, d));
+        } else {
+            if (habia) {
+                MarcarColumnas(fila, a, b);
+            }
+            if (hay) {
+                MarcarColumnas(fila, c, d);
+            }
+        }
+    }
+}
+
+static void ComponerFila(int fila, int desde, int hasta) {
+    const uint16_t colores[CANTIDAD_AGUJAS] = {
+        esfera.colores->aguja_hora, esfera.colores->aguja_minuto, esfera.colores->aguja_segundo};
+    int columna = 0, fin, izquierda, derecha, mitad, dy = fila - esfera.radio;
+
+    // La esfera sale de las corridas de la fila, después se superponen las agujas y el centro
+    for (int indice = esfera.inicio[fila]; (indice < esfera.inicio[fila + 1]) && (columna <= hasta); indice++) {
+        fin = columna + CORRIDA_LONGITUD(corridas[indice]) - 1;
+        for (int pixel = Mayor(columna, desde); pixel <= Menor(fin, hasta); pixel++) {
+            linea[pixel] = esfera.paleta[CORRIDA_COLOR(corridas[indice])];
+        }
+        columna = fin + 1;
+    }
+    for (int aguja = 0; aguja < CANTIDAD_AGUJAS; aguja++) {
+        if (TramoAguja(&agujas[aguja], fila, &izquierda, &derecha)) {
+            for (int pixel = Mayor(izquierda, desde); pixel <= Menor(derecha, hasta); pixel++) {
+                linea[pixel] = colores[aguja];
+            }
+        }
+    }
+    if ((dy >= -RADIO_CENTRO) && (dy <= RADIO_CENTRO)) {
+        mitad = (int)sqrtf(RADIO_CENTRO * RADIO_CENTRO - dy * dy);
+        for (int pixel = Mayor(esfera.radio - mitad, desde); pixel <= Menor(esfera.radio + mitad, hasta); pixel++) {
+            linea[pixel] = esfera.colores->aguja_segundo;
+        }
+    }
+}
+
+static void PintarBloque(int primera, int ultima, int desde, int hasta) {
+    int inicio;
+
+    ILI9341BeginArea(esfera.x + desde, esfera.y + primera, esfera.x + hasta, esfera.y + ultima);
+    for (int fila = primera; fila <= ultima; fila++) {
+        ComponerFila(fila, desde, hasta);
+        inicio = desde;
+        for (int pixel = desde + 1; pixel <= hasta + 1; pixel++) {
+            if ((pixel > hasta) || (linea[pixel] != linea[inicio])) {
+                ILI9341WriteColor(linea[inicio], pixel - inicio);
+                inicio = pixel;
+            }
+        }
+    }
+    ILI9341EndArea();
+}
+
+static void PintarMarcadas(void) {
+    int primera = -1, desde = 0, hasta = 0, pixeles = 0, nuevo_desde, nuevo_hasta;
+
+    for (int fila = 0; fila <= esfera.lado; fila++) {
+        int limpia = (fila == esfera.lado) || (sucia_hasta[fila] < sucia_desde[fila]);
+
+        if (primera >= 0) {
+            if (!limpia) {
+                // La fila se suma al bloque si los pixeles de más cuestan menos que abrir otra ventana
+                nuevo_desde = Menor(desde, sucia_desde[fila]);
+                nuevo_hasta = Mayor(hasta, sucia_hasta[fila]);
+                if ((fila - primera + 1) * (nuevo_hasta - nuevo_desde + 1) <=
+                    pixeles + sucia_hasta[fila] - sucia_desde[fila] + 1 + COSTO_VENTANA) {
+                    desde = nuevo_desde;
+                    hasta = nuevo_hasta;
+                    pixeles = (fila - primera + 1) * (hasta - desde + 1);
+                    continue;
+                }
+            }
+            PintarBloque(primera, fila - 1, desde, hasta);
+            primera = -1;
+        }
+        if (!limpia) {
+            primera = fila;
+            desde = sucia_desde[fila];
+            hasta = sucia_hasta[fila];
+            pixeles = hasta - desde + 1;
+        }
+    }
+
+    for (int fila = 0; fila < esfera.lado; fila++) {
+        sucia_desde[fila] = esfera.lado;
+        sucia_hasta[fila] = -1;
+    }
+}
+
+/* === Public function implementation ============================================================================== */
+
+bool CrearEsfera(uint16_t x, uint16_t y, uint16_t radio, const colores_esfera_t * colores) {
+    uint16_t usadas = 0, longitud;
+    uint8_t color, siguiente;
+
+    esfera.radio = 0;
+    if ((radio > RADIO_MAXIMO_ESFERA) || (radio > x) || (radio > y)) {
+        return false;
+    }
+    esfera.x = x - radio;
+    esfera.y = y - radio;
+    esfera.radio = radio;
+    esfera.lado = 2 * radio + 1;
+    esfera.colores = colores;
+    esfera.paleta[COLOR_FONDO] = colores->fondo;
+    esfera.paleta[COLOR_ESFERA] = colores->esfera;
+    esfera.paleta[COLOR_BORDE] = colores->borde;
+    esfera.paleta[COLOR_MINUTOS] = colores->minutos;
+    esfera.paleta[COLOR_HORAS] = colores->horas;
+
+    for (int fila = 0; fila < esfera.lado; fila++) {
+        esfera.inicio[fila] = usadas;
+        color = ColorEsfera(-radio, fila - radio);
+        longitud = 0;
+        for (int columna = 0; columna <= esfera.lado; columna++) {
+            siguiente = (columna < esfera.lado) ? ColorEsfera(columna - radio, fila - radio) : CANTIDAD_COLORES;
+            if ((siguiente != color) || (longitud == LONGITUD_MAXIMA)) {
+                if (usadas == MEMORIA_ESFERA) {
+                    esfera.radio = 0;
+                    return false;
+                }
+                corridas[usadas++] = CORRIDA(color, longitud);
+                color = siguiente;
+                longitud = 0;
+            }
+            longitud++;
+        }
+    }
+    esfera.inicio[esfera.lado] = usadas;
+
+    for (int aguja = 0; aguja < CANTIDAD_AGUJAS; aguja++) {
+        agujas[aguja].posicion = SIN_POSICION;
+        agujas[aguja].filas = 0;
+    }
+    for (int fila = 0; fila < esfera.lado; fila++) {
+        sucia_desde[fila] = esfera.lado;
+        sucia_hasta[fila] = -1;
+    }
+    return true;
+}
+
+void DibujarEsfera(void) {
+    if (esfera.radio == 0) {
+        return;
+    }
+    ILI9341StartBatch();
+    PintarBloque(0, esfera.lado - 1, 0, esfera.lado - 1);
+    ILI9341EndBatch();
+}
+
+void MoverAgujas(uint8_t hora, uint8_t minuto, uint8_t segundo) {
+    int16_t posiciones[CANTIDAD_AGUJAS] = {
+        [AGUJA_HORA] = (hora % 12) * 60 + minuto,
+        [AGUJA_MINUTO] = minuto,
+        [AGUJA_SEGUNDO] = segundo,
+    };
+    int movidas = 0;
+
+    if (esfera.radio == 0) {
+        return;
+    }
+    for (int aguja = 0; aguja < CANTIDAD_AGUJAS; aguja++) {
+        if (agujas[aguja].posicion != posiciones[aguja]) {
+            memcpy(&anterior, &agujas[aguja], sizeof(anterior));
+            agujas[aguja].posicion = posiciones[aguja];
+            CalcularTramos(&agujas[aguja], &FORMAS[aguja]);
+            MarcarDiferencias(&anterior, &agujas[aguja]);
+            movidas++;
+        }
+    }
+    // Se pinta después de mover todas las agujas, así cada pixel se compone con las posiciones nuevas
+    if (movidas) {
+        ILI9341StartBatch();
+        PintarMarcadas();
+        ILI9341EndBatch();
+    }
+}
+
+uint32_t MemoriaEsfera(void) {
+    return (esfera.radio != 0) ? esfera.inicio[esfera.lado] : 0;
+}
+
+/* === End of documentation ======================================================================================== */
@@ -0,0 +1,121 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+
+#ifndef ESFERA_H_
+#define ESFERA_H_
+
+/** @file esfera.h
+ ** @brief Declaraciones de la biblioteca para dibujar un reloj de agujas en una pantalla TFT
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* === Cabecera C++ ================================================================================================ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* === Public macros definitions =================================================================================== */
+
+//! @brief Radio máximo en pixeles de la esfera del reloj
+#ifndef RADIO_MAXIMO_ESFERA
+#define RADIO_MAXIMO_ESFERA 120
+#endif
+
+//! @brief Cantidad de bytes reservados para las corridas de la esfera pre-dibujada
+#ifndef MEMORIA_ESFERA
+#define MEMORIA_ESFERA 4096
+#endif
+
+/* === Public data type declarations =============================================================================== */
+
+/**
+ * @brief Colores de la esfera y de las agujas del reloj
+ */
+typedef struct colores_esfera_s {
+    uint16_t fondo;         //!< Color alrededor de la esfera
+    uint16_t esfera;        //!< Color de la esfera, debajo de las marcas y las agujas
+    uint16_t borde;         //!< Color del borde de la esfera
+    uint16_t minutos;       //!< Color de las marcas de los minutos
+    uint16_t horas;         //!< Color de las marcas de las horas
+    uint16_t aguja_hora;    //!< Color de la aguja de las horas
+    uint16_t aguja_minuto;  //!< Color de la aguja de los minutos
+    uint16_t aguja_segundo; //!< Color de la aguja de los segundos y del centro
+} colores_esfera_t;
+
+/* === Public variable declarations ================================================================================ */
+
+/* === Public function declarations ================================================================================ */
+
+/**
+ * @brief Función que crea la esfera del reloj de agujas
+ *
+ * La esfera con sus marcas se dibuja una sola vez en memoria, comprimida como corridas de pixeles del mismo color
+ * en cada fila. Las corridas se usan para restaurar la esfera debajo de las agujas que se mueven sin volver a
+ * calcular las marcas. Las agujas quedan sin dibujar hasta la primera llamada a @ref MoverAgujas.
+ *
+ * @param  x          Posición horizontal del centro de la esfera
+ * @param  y          Posición vertical del centro de la esfera
+ * @param  radio      Radio en pixeles de la esfera, hasta @ref RADIO_MAXIMO_ESFERA
+ * @param  colores    Colores de la esfera y de las agujas, deben existir mientras exista la esfera
+ * @return bool       true si se creó la esfera, false si el radio es muy grande o no alcanza la memoria
+ */
+bool CrearEsfera(uint16_t x, uint16_t y, uint16_t radio, const colores_esfera_t * colores);
+
+/**
+ * @brief Función que dibuja completa la esfera con las agujas en su posición actual
+ *
+ * Se usa cuando la esfera aparece en la pantalla, después solo se repintan los pixeles que cambian con
+ * @ref MoverAgujas.
+ */
+void DibujarEsfera(void);
+
+/**
+ * @brief Función que mueve las agujas a una hora y repinta solo los pixeles que cambian
+ *
+ * Cada aguja guarda los tramos horizontales que ocupa en cada fila. Cuando una aguja se mueve se comparan los tramos
+ * de la posición anterior con los de la nueva, y solo se pintan las diferencias, con la esfera restaurada desde las
+ * corridas y las otras agujas por encima. Las filas vecinas con cambios se envían juntas en una misma ventana
+ * mientras eso cueste menos que abrir ventanas separadas. Un segundo mueve unos pocos cientos de pixeles.
+ *
+ * @param  hora       Hora, de 0 a 23. La aguja avanza con los minutos
+ * @param  minuto     Minutos, de 0 a 59
+ * @param  segundo    Segundos, de 0 a 59
+ */
+void MoverAgujas(uint8_t hora, uint8_t minuto, uint8_t segundo);
+
+/**
+ * @brief Función para consultar la memoria usada por la esfera pre-dibujada
+ *
+ * @return uint32_t  Cantidad de bytes ocupados por las corridas, de los reservados con @ref MEMORIA_ESFERA
+ */
+uint32_t MemoriaEsfera(void);
+
+/* === End of documentation ======================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ESFERA_H_ */
@@ -30,6 +30,9 @@ SPDX-License-Identifier: MIT
 #include "freertos/task.h"
 #include "driver/spi_master.h"
 #include "driver/gpio.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "nvs.h"
 #include <string.h>
 
 /* === Macros definitions ====================================================================== */
@@ -39,10 +42,18 @@ SPDX-License-Identifier: MIT
 // is dividable by this.
 #define PARALLEL_LINES    16
 
-#define SPI_BR            51000000      /*!< Frequency of sck for SPI communication */
+#define SPI_BR            40000000      /*!< Maximum frequency of sck for SPI communication */
+#define SPI_SAFE_BR       10000000      /*!< Frequency of sck that works on every board, used until calibration */
+#define SPI_READ_BR       6000000       /*!< Frequency of sck for frame memory reads, read cycle is 150 ns */
+#define READ_PIXELS       128           /*!< Pixels received on each frame memory read transfer */
+#define CALIBRATION_PIXELS 240          /*!< Pixels of the test pattern written on each calibration step */
+#define CALIBRATION_NVS   "ili9341"     /*!< NVS namespace where the calibrated clock is stored */
+#define CALIBRATION_KEY   "spi_hz"      /*!< NVS key of the calibrated clock */
 #define MAX_PIXEL         320 * 240 * 2 /*!< Maximum number of bytes to write on LCD */
 #define MSK_BIT16         0x8000        /*!< 16th bit mask */
 #define MAX_VALUE_SIZE    256           /*!< Maximum length of a data array to \  prevent excessive use of memory */
+#define SURFACE_BUFFER    1024          /*!< Bytes of expanded RGB565 pixels sent on each surface transfer */
+#define STREAM_BUFFER     1024          /*!< Bytes of RGB565 pixels buffered by a streamed window */
 #define LEFT              -1            /*!< Horizontal grow direction */
 #define RIGHT             1             /*!< Horizontal grow direction */
 #define DOWN              1             /*!< Vertical grow direction */
@@ -61,6 +72,7 @@ SPDX-License-Identifier: MIT
 #define COLUMN_ADDR_SET   0x2A /*!< Define columns of frame memory where MCU can access */
 #define PAGE_ADDR_SET     0x2B /*!< Define rows of frame memory where MCU can access */
 #define MEM_WRITE         0x2C /*!< Transfer data from MCU to frame memory */
+#define MEM_READ          0x2E /*!< Transfer data from frame memory to MCU */
 #define MEM_ACC_CTRL      0x36 /*!< Defines read/write scanning direction of frame memory */
 #define PIXEL_FORMAT_SET  0x3A /*!< Sets the pixel format for the RGB image data used by the interface */
 #define WRITE_DISP_BRIGHT 0x51 /*!< Adjust the brightness value of the display */
@@ -155,9 +167,79 @@ void SetCursorPosition(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
  */
 void Fill(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color);
 
+/**
+ * @brief  		Attach the LCD to the SPI bus, replacing the previous attachment
+ * @param[in]  	clock_speed_hz: Frequency of sck for the LCD
+ * @retval 		None
+ */
+static void spi_attach(int clock_speed_hz);
+
+/**
+ * @brief  		Read an area of the frame memory, the SPI clock must already be a safe read clock
+ * @param[in]  	x0: Start column
+ * @param[in]  	y0: Start row
+ * @param[in]  	x1: End column
+ * @param[in]  	y1: End row
+ * @param[out]	colors: RGB565 colors of the area, row by row
+ * @retval 		None
+ */
+static void ReadArea(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t * colors);
+
+/**
+ * @brief  		Write an area of the frame memory with a buffer of colors
+ * @param[in]  	x0: Start column
+ * @param[in]  	y0: Start row
+ * @param[in]  	x1: End column
+ * @param[in]  	y1: End row
+ * @param[in]	colors: RGB565 colors of the area, row by row
+ * @retval 		None
+ */
+static void WriteArea(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, const uint16_t * colors);
+
+/**
+ * @brief  		Write a test pattern at a clock rate and verify it reading back the frame memory
+ * @param[in]  	clock_speed_hz: Frequency of sck to verify
+ * @retval 		true if the pattern was read back without errors
+ */
+static bool VerifyClock(int clock_speed_hz);
+
+/**
+ * @brief  		Get the color of a sprite pixel
+ * @param[in]  	sprite: Sprite description
+ * @param[in]  	index: Index of the pixel in the sprite data
+ * @param[out]	color: RGB565 color of the pixel
+ * @retval 		true if the pixel is opaque, false if it matches the transparent key
+ */
+static bool SpritePixel(const ili9341_sprite_t * sprite, uint32_t index, uint16_t * color);
+
+/**
+ * @brief  		Send a run of opaque sprite pixels in its own one row window
+ * @param[in]  	sprite: Sprite description
+ * @param[in]  	index: Index in the sprite data of the first pixel of the run
+ * @param[in]  	x: Start column of the run on the LCD
+ * @param[in]  	y: Row of the run on the LCD
+ * @param[in]  	length: Number of pixels of the run
+ * @retval 		None
+ */
+static void SpriteRun(const ili9341_sprite_t * sprite, uint32_t index, uint16_t x, uint16_t y, uint16_t length);
+
 /* === Public variable definitions ============================================================= */
 
 static spi_device_handle_t spi;
+static int spi_clock; /*!< Frequency of sck of the current LCD attachment */
+static int batch_depth; /*!< Nesting level of the batches, the bus is held while it isn't zero */
+static ili9341_stats_t traffic; /*!< Traffic sent to the LCD since the last reset */
+
+static const char * TAG = "ili9341";
+
+static uint8_t stream_pixels[STREAM_BUFFER]; /*!< Pixels of the streamed window not sent yet */
+static uint16_t stream_count;                /*!< Bytes used in the stream buffer */
+
+/**
+ * @brief Clock rates tried by the calibration, from fastest to slowest. All of them are exact divisions of the 80 MHz
+ * APB clock, the driver would round any other value down to one of these.
+ */
+static const int spi_clock_ladder[] = {SPI_BR, 26666666, 20000000, 16000000, 13333333, SPI_SAFE_BR};
 
 /* === Private variable definitions ============================================================ */
 
@@ -264,6 +346,7 @@ void lcd_data(const uint8_t * data, int len) {
     if (len == 0) {
         return; // no need to send anything
     }
+    traffic.bytes += len;
     memset(&t, 0, sizeof(t));                   // Zero out the transaction
     t.length = len * 8;                         // Len is in bytes, transaction length is in bits.
     t.tx_buffer = data;                         // Data
@@ -291,25 +374,34 @@ void spi_config() {
         .max_transfer_sz = PARALLEL_LINES * 320 * 2 + 8,
     };
 
+    // Initialize the SPI bus
+    ret = spi_bus_initialize(ILI9341_SPI_PORT, &buscfg, SPI_DMA_CH_AUTO);
+    ESP_ERROR_CHECK(ret);
+
+    // Attach the LCD to the SPI bus, the final clock is selected by ILI9341Calibrate
+    spi_attach(SPI_SAFE_BR);
+}
+
+static void spi_attach(int clock_speed_hz) {
+    esp_err_t ret;
+
     spi_device_interface_config_t devcfg = {
-#ifdef CONFIG_LCD_OVERCLOCK
-        .clock_speed_hz = 26 * 1000 * 1000, // Clock out at 26 MHz
-#else
-        .clock_speed_hz = 10 * 1000 * 1000, // Clock out at 10 MHz
-#endif
+        .clock_speed_hz = clock_speed_hz,
         .mode = 0,                               // SPI mode 0
         .spics_io_num = ILI9341_PIN_NUM_CS,      // CS pin
         .queue_size = 7,                         // We want to be able to queue 7 transactions at a time
         .pre_cb = lcd_spi_pre_transfer_callback, // Specify pre-transfer callback to handle D/C line
     };
 
-    // Initialize the SPI bus
-    ret = spi_bus_initialize(ILI9341_SPI_PORT, &buscfg, SPI_DMA_CH_AUTO);
-    ESP_ERROR_CHECK(ret);
-
-    // Attach the LCD to the SPI bus
+    // The clock of a device can't be changed, so it is removed and attached again
+    assert(batch_depth == 0);
+    if (spi != NULL) {
+        ret = spi_bus_remove_device(spi);
+        ESP_ERROR_CHECK(ret);
+    }
     ret = spi_bus_add_device(ILI9341_SPI_PORT, &devcfg, &spi);
     ESP_ERROR_CHECK(ret);
+    spi_clock = clock_speed_hz;
 }
 
 void WriteLCD(lcd_cmd_t * data) {
@@ -343,6 +435,7 @@ void SetCursorPosition(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
     lcd_cmd_t lcd_columns = {COLUMN_ADDR_SET, 4, columns};
     uint8_t rows[] = {HighByte(y0), LowByte(y0), HighByte(y1), LowByte(y1)};
     lcd_cmd_t lcd_rows = {PAGE_ADDR_SET, 4, rows};
+    traffic.windows++;
     WriteLCD(&lcd_columns);
     WriteLCD(&lcd_rows);
 }
@@ -383,6 +476,140 @@ void Fill(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color) {
     WriteLCD(&lcd_pixel);
 }
 
+static bool SpritePixel(const ili9341_sprite_t * sprite, uint32_t index, uint16_t * color) {
+    if (sprite->format == ILI9341_SPRITE_INDEXED) {
+        uint8_t entry = ((const uint8_t *)sprite->data)[index];
+        *color = sprite->palette[entry];
+        return entry != sprite->key;
+    }
+    *color = ((const uint16_t *)sprite->data)[index];
+    return *color != sprite->key;
+}
+
+static void SpriteRun(const ili9341_sprite_t * sprite, uint32_t index, uint16_t x, uint16_t y, uint16_t length) {
+    static uint8_t pixel[MAX_VALUE_SIZE];
+    uint16_t i, count, color;
+
+    SetCursorPosition(x, y, x + length - 1, y);
+
+    /* Start writing LCD memory */
+    lcd_cmd_t lcd_write = {MEM_WRITE, 0, NULL};
+    WriteLCD(&lcd_write);
+
+    count = 0;
+    for (i = 0; i < length; i++) {
+        SpritePixel(sprite, index + i, &color);
+        pixel[count++] = HighByte(color);
+        pixel[count++] = LowByte(color);
+        /* If the buffer is full, send it */
+        if (count == MAX_VALUE_SIZE) {
+            lcd_cmd_t lcd_pixel = {SEND_PIXELS, count, pixel};
+            WriteLCD(&lcd_pixel);
+            count = 0;
+        }
+    }
+    /* Send the rest of the buffer */
+    lcd_cmd_t lcd_pixel = {SEND_PIXELS, count, pixel};
+    WriteLCD(&lcd_pixel);
+}
+
+static void ReadArea(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t * colors) {
+    DMA_ATTR static uint8_t pixel[READ_PIXELS * 3];
+    esp_err_t ret;
+    spi_transaction_t t;
+    uint32_t pending, count, i;
+
+    pending = (uint32_t)((x1 > x0) ? x1 - x0 + 1 : x0 - x1 + 1) * ((y1 > y0) ? y1 - y0 + 1 : y0 - y1 + 1);
+
+    /* CS must stay active from the read command to the last pixel, so the bus is reserved */
+    ILI9341StartBatch();
+
+    SetCursorPosition(x0, y0, x1, y1);
+    lcd_cmd(MEM_READ, true);
+
+    /* The first byte after the read command is a dummy one */
+    memset(&t, 0, sizeof(t));
+    t.length = 8;
+    t.flags = SPI_TRANS_USE_RXDATA | SPI_TRANS_CS_KEEP_ACTIVE;
+    t.user = (void *)1;
+    ret = spi_device_polling_transmit(spi, &t);
+    assert(ret == ESP_OK);
+
+    /* Each pixel is received as three bytes with 6 bits of red, green and blue */
+    while (pending > 0) {
+        count = (pending > READ_PIXELS) ? READ_PIXELS : pending;
+        pending -= count;
+
+        memset(&t, 0, sizeof(t));
+        t.length = count * 3 * 8;
+        t.rx_buffer = pixel;
+        t.user = (void *)1;
+        if (pending > 0) {
+            t.flags = SPI_TRANS_CS_KEEP_ACTIVE;
+        }
+        ret = spi_device_polling_transmit(spi, &t);
+        assert(ret == ESP_OK);
+
+        for (i = 0; i < count; i++) {
+            *colors++ = ((pixel[3 * i] & 0xF8) << 8) | ((pixel[3 * i + 1] & 0xFC) << 3) | (pixel[3 * i + 2] >> 3);
+        }
+    }
+    ILI9341EndBatch();
+}
+
+static void WriteArea(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, const uint16_t * colors) {
+    static uint8_t pixel[MAX_VALUE_SIZE];
+    uint32_t pending, count;
+
+    pending = (uint32_t)((x1 > x0) ? x1 - x0 + 1 : x0 - x1 + 1) * ((y1 > y0) ? y1 - y0 + 1 : y0 - y1 + 1);
+
+    SetCursorPosition(x0, y0, x1, y1);
+
+    /* Start writing LCD memory */
+    lcd_cmd_t lcd_write = {MEM_WRITE, 0, NULL};
+    WriteLCD(&lcd_write);
+
+    count = 0;
+    while (pending > 0) {
+        pixel[count++] = HighByte(*colors);
+        pixel[count++] = LowByte(*colors);
+        colors++;
+        pending--;
+        /* If the buffer is full or the area is complete, send it */
+        if ((count == MAX_VALUE_SIZE) || (pending == 0)) {
+            lcd_cmd_t lcd_pixel = {SEND_PIXELS, count, pixel};
+            WriteLCD(&lcd_pixel);
+            count = 0;
+        }
+    }
+}
+
+static bool VerifyClock(int clock_speed_hz) {
+    static uint16_t pattern[CALIBRATION_PIXELS];
+    static uint16_t colors[CALIBRATION_PIXELS];
+    uint16_t i;
+
+    /* Alternate bits and ramps to exercise every line transition */
+    for (i = 0; i < CALIBRATION_PIXELS; i++) {
+        switch (i % 4) {
+        case 0:
+            pattern[i] = 0xAAAA;
+            break;
+        case 1:
+            pattern[i] = 0x5555;
+            break;
+        default:
+            pattern[i] = (i * 0x0841) ^ (i << 9);
+            break;
+        }
+    }
+
+    spi_attach(clock_speed_hz);
+    WriteArea(0, 0, CALIBRATION_PIXELS - 1, 0, pattern);
+    return (ILI9341ReadRect(0, 0, CALIBRATION_PIXELS - 1, 0, colors) == ESP_OK) &&
+           (memcmp(pattern, colors, sizeof(pattern)) == 0);
+}
+
 /* === Public function implementation ========================================================== */
 
 void ILI9341Init(void) {
@@ -416,6 +643,9 @@ void ILI9341Init(void) {
     WriteLCD(&lcd_on);
     vTaskDelay(10 / portTICK_PERIOD_MS);
 
+    /* Select the fastest SPI clock this board supports */
+    ILI9341Calibrate(false);
+
     /* Enable backlight */
     gpio_set_level(ILI9341_PIN_NUM_BCKL, ILI9341_BK_LIGHT_ON_LEVEL);
 
@@ -423,6 +653,66 @@ void ILI9341Init(void) {
     ILI9341Fill(ILI9341_BLACK);
 }
 
+void ILI9341StartBatch(void) {
+    esp_err_t ret;
+
+    if (batch_depth++ == 0) {
+        ret = spi_device_acquire_bus(spi, portMAX_DELAY);
+        assert(ret == ESP_OK);
+    }
+}
+
+void ILI9341EndBatch(void) {
+    if ((batch_depth > 0) && (--batch_depth == 0)) {
+        spi_device_release_bus(spi);
+    }
+}
+
+void ILI9341GetStats(ili9341_stats_t * stats) {
+    *stats = traffic;
+}
+
+void ILI9341ResetStats(void) {
+    memset(&traffic, 0, sizeof(traffic));
+}
+
+int ILI9341Calibrate(bool force) {
+    nvs_handle_t nvs;
+    uint32_t stored = 0;
+    bool persistent;
+    int clock = SPI_SAFE_BR;
+
+    persistent = (nvs_open(CALIBRATION_NVS, NVS_READWRITE, &nvs) == ESP_OK);
+    if (persistent && !force && (nvs_get_u32(nvs, CALIBRATION_KEY, &stored) == ESP_OK)) {
+        /* Reuse the result of a previous boot if it is still one of the known rates */
+        for (uint8_t i = 0; i < sizeof(spi_clock_ladder) / sizeof(int); i++) {
+            if (spi_clock_ladder[i] == (int)stored) {
+                spi_attach(stored);
+                nvs_close(nvs);
+                ESP_LOGI(TAG, "SPI clock %lu Hz restored from NVS", (unsigned long)stored);
+                return stored;
+            }
+        }
+    }
+
+    for (uint8_t i = 0; i < sizeof(spi_clock_ladder) / sizeof(int); i++) {
+        if (VerifyClock(spi_clock_ladder[i])) {
+            clock = spi_clock_ladder[i];
+            break;
+        }
+        ESP_LOGW(TAG, "SPI clock %d Hz failed verification", spi_clock_ladder[i]);
+    }
+    spi_attach(clock);
+    ESP_LOGI(TAG, "SPI clock %d Hz selected by calibration", clock);
+
+    if (persistent) {
+        nvs_set_u32(nvs, CALIBRATION_KEY, clock);
+        nvs_commit(nvs);
+        nvs_close(nvs);
+    }
+    return clock;
+}
+
 void ILI9341DrawPixel(uint16_t x, uint16_t y, uint16_t color) {
     /* Define area (pixel) to fill */
     SetCursorPosition(x, y, x, y);
@@ -474,6 +764,11 @@ void ILI9341Rotate(ili9341_orientation_t orientation) {
     WriteLCD(&lcd_mem_acc);
 }
 
+void ILI9341Invert(bool invert) {
+    lcd_cmd_t lcd_invert = {invert ? DISPLAY_INV_ON : DISPLAY_INV_OFF, 0, NULL};
+    WriteLCD(&lcd_invert);
+}
+
 void ILI9341DrawChar(uint16_t x, uint16_t y, char data, Font_t * font, uint16_t foreground, uint16_t background) {
     static uint16_t i, j, k;
     static uint16_t char_row;
@@ -755,4 +1050,235 @@ void ILI9341DrawPicture(uint16_t x, uint16_t y, uint16_t width, uint16_t height,
     WriteLCD(&lcd_pixel);
 }
 
+void ILI9341DrawSprite(int16_t x, int16_t y, const ili9341_sprite_t * sprite) {
+    int32_t row, col, start, first_row, last_row, first_col, last_col;
+    uint32_t base;
+    uint16_t color;
+
+    /* Clip the sprite to the visible area of the LCD */
+    first_col = (x < 0) ? -x : 0;
+    first_row = (y < 0) ? -y : 0;
+    last_col = sprite->width;
+    last_row = sprite->height;
+    if (x + last_col > lcd_orientation.width) {
+        last_col = lcd_orientation.width - x;
+    }
+    if (y + last_row > lcd_orientation.height) {
+        last_row = lcd_orientation.height - y;
+    }
+
+    for (row = first_row; row < last_row; row++) {
+        base = row * sprite->width;
+        col = first_col;
+        while (col < last_col) {
+            /* Skip the transparent pixels */
+            while ((col < last_col) && !SpritePixel(sprite, base + col, &color)) {
+                col++;
+            }
+            /* Find the end of the opaque run */
+            start = col;
+            while ((col < last_col) && SpritePixel(sprite, base + col, &color)) {
+                col++;
+            }
+            if (col > start) {
+                SpriteRun(sprite, base + start, x + start, y + row, col - start);
+            }
+        }
+    }
+}
+
+void ILI9341SurfaceInit(ili9341_surface_t * surface, uint16_t width, uint16_t height, uint8_t bpp, uint8_t * data,
+                        uint16_t * palette) {
+    assert((bpp == 1) || (bpp == 2) || (bpp == 4) || (bpp == 8));
+
+    surface->width = width;
+    surface->height = height;
+    surface->bpp = bpp;
+    surface->data = data;
+    surface->palette = palette;
+    memset(data, 0, ILI9341_SURFACE_SIZE(width, height, bpp));
+}
+
+void ILI9341SurfaceSetPalette(ili9341_surface_t * surface, uint8_t index, uint16_t color) {
+    if (index < (1 << surface->bpp)) {
+        surface->palette[index] = color;
+    }
+}
+
+void ILI9341SurfaceSetPixel(ili9341_surface_t * surface, uint16_t x, uint16_t y, uint8_t index) {
+    uint32_t bit;
+    uint8_t mask, shift;
+    uint8_t * byte;
+
+    if ((x >= surface->width) || (y >= surface->height)) {
+        return;
+    }
+    bit = (uint32_t)x * surface->bpp;
+    byte = &surface->data[(uint32_t)y * ILI9341_SURFACE_STRIDE(surface->width, surface->bpp) + bit / 8];
+    /* Pixels are packed from the most significant bit of each byte */
+    shift = 8 - surface->bpp - (bit % 8);
+    mask = ((1 << surface->bpp) - 1) << shift;
+    *byte = (*byte & ~mask) | ((index << shift) & mask);
+}
+
+uint8_t ILI9341SurfaceGetPixel(const ili9341_surface_t * surface, uint16_t x, uint16_t y) {
+    uint32_t bit;
+    uint8_t byte, shift;
+
+    if ((x >= surface->width) || (y >= surface->height)) {
+        return 0;
+    }
+    bit = (uint32_t)x * surface->bpp;
+    byte = surface->data[(uint32_t)y * ILI9341_SURFACE_STRIDE(surface->width, surface->bpp) + bit / 8];
+    shift = 8 - surface->bpp - (bit % 8);
+    return (byte >> shift) & ((1 << surface->bpp) - 1);
+}
+
+void ILI9341SurfaceFillRectangle(ili9341_surface_t * surface, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1,
+                                 uint8_t index) {
+    uint16_t x, y;
+
+    /* An empty surface would make the clipped end coordinates wrap around */
+    if ((surface->width == 0) || (surface->height == 0)) {
+        return;
+    }
+    if (x1 >= surface->width) {
+        x1 = surface->width - 1;
+    }
+    if (y1 >= surface->height) {
+        y1 = surface->height - 1;
+    }
+    for (y = y0; y <= y1; y++) {
+        for (x = x0; x <= x1; x++) {
+            ILI9341SurfaceSetPixel(surface, x, y, index);
+        }
+    }
+}
+
+void ILI9341SurfaceDrawSprite(ili9341_surface_t * surface, int16_t x, int16_t y, const ili9341_sprite_t * sprite) {
+    int32_t row, col;
+    uint8_t index;
+    const uint8_t * data = sprite->data;
+
+    /* Only indexed sprites share the palette of the surface */
+    if (sprite->format != ILI9341_SPRITE_INDEXED) {
+        return;
+    }
+    for (row = 0; row < sprite->height; row++) {
+        if ((y + row < 0) || (y + row >= surface->height)) {
+            continue;
+        }
+        for (col = 0; col < sprite->width; col++) {
+            index = data[row * sprite->width + col];
+            if ((index != sprite->key) && (x + col >= 0)) {
+                ILI9341SurfaceSetPixel(surface, x + col, y + row, index);
+            }
+        }
+    }
+}
+
+void ILI9341SurfaceFlushArea(const ili9341_surface_t * surface, uint16_t x, uint16_t y, uint16_t x0, uint16_t y0,
+                             uint16_t x1, uint16_t y1) {
+    static uint8_t pixel[SURFACE_BUFFER];
+    uint32_t bit, count, stride;
+    uint16_t row, col, color;
+    uint8_t mask;
+    const uint8_t * line;
+
+    /* Clip the area to the surface, an empty surface would make the end coordinates wrap around */
+    if ((surface->width == 0) || (surface->height == 0)) {
+        return;
+    }
+    if (x1 >= surface->width) {
+        x1 = surface->width - 1;
+    }
+    if (y1 >= surface->height) {
+        y1 = surface->height - 1;
+    }
+    if ((x0 > x1) || (y0 > y1)) {
+        return;
+    }
+
+    SetCursorPosition(x + x0, y + y0, x + x1, y + y1);
+
+    /* Start writing LCD memory */
+    lcd_cmd_t lcd_write = {MEM_WRITE, 0, NULL};
+    WriteLCD(&lcd_write);
+
+    stride = ILI9341_SURFACE_STRIDE(surface->width, surface->bpp);
+    mask = (1 << surface->bpp) - 1;
+    count = 0;
+    for (row = y0; row <= y1; row++) {
+        line = &surface->data[row * stride];
+        for (col = x0; col <= x1; col++) {
+            /* Expand the palette index to its RGB565 color */
+            bit = (uint32_t)col * surface->bpp;
+            color = surface->palette[(line[bit / 8] >> (8 - surface->bpp - (bit % 8))) & mask];
+            pixel[count++] = HighByte(color);
+            pixel[count++] = LowByte(color);
+            /* If the buffer is full, send it */
+            if (count == SURFACE_BUFFER) {
+                lcd_cmd_t lcd_pixel = {SEND_PIXELS, count, pixel};
+                WriteLCD(&lcd_pixel);
+                count = 0;
+            }
+        }
+    }
+    /* Send the rest of the buffer */
+    lcd_cmd_t lcd_pixel = {SEND_PIXELS, count, pixel};
+    WriteLCD(&lcd_pixel);
+}
+
+void ILI9341SurfaceFlush(const ili9341_surface_t * surface, uint16_t x, uint16_t y) {
+    ILI9341SurfaceFlushArea(surface, x, y, 0, 0, surface->width - 1, surface->height - 1);
+}
+
+esp_err_t ILI9341ReadRect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t * colors) {
+    int clock = spi_clock;
+
+    /* The read clock needs a new attachment, which can't be done while a batch holds the bus */
+    if (batch_depth != 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (clock > SPI_READ_BR) {
+        spi_attach(SPI_READ_BR);
+    }
+    ReadArea(x0, y0, x1, y1, colors);
+    if (clock != spi_clock) {
+        spi_attach(clock);
+    }
+    return ESP_OK;
+}
+
+void ILI9341BeginArea(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+    SetCursorPosition(x0, y0, x1, y1);
+
+    /* Start writing LCD memory */
+    lcd_cmd_t lcd_write = {MEM_WRITE, 0, NULL};
+    WriteLCD(&lcd_write);
+    stream_count = 0;
+}
+
+void ILI9341WriteColor(uint16_t color, uint32_t count) {
+    while (count > 0) {
+        stream_pixels[stream_count++] = HighByte(color);
+        stream_pixels[stream_count++] = LowByte(color);
+        count--;
+        /* If the buffer is full, send it and keep filling it with the rest of the run */
+        if (stream_count == STREAM_BUFFER) {
+            lcd_cmd_t lcd_pixel = {SEND_PIXELS, stream_count, stream_pixels};
+            WriteLCD(&lcd_pixel);
+            stream_count = 0;
+        }
+    }
+}
+
+void ILI9341EndArea(void) {
+    if (stream_count > 0) {
+        lcd_cmd_t lcd_pixel = {SEND_PIXELS, stream_count, stream_pixels};
+        WriteLCD(&lcd_pixel);
+        stream_count = 0;
+    }
+}
+
 /* === End of documentation ==================================================================== */
@@ -29,6 +29,8 @@ SPDX-License-Identifier: MIT
 /* === Headers files inclusions ================================================================ */
 
 #include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
 #include "fonts.h"
 
 /* === Cabecera C++ ============================================================================ */
@@ -82,6 +84,10 @@ extern "C" {
 #define ILI9341_PINK              0xF81F
 #define ILI9341_BROWN             0xBBCA
 
+/* Offscreen surfaces */
+#define ILI9341_SURFACE_STRIDE(width, bpp)       (((width) * (bpp) + 7) / 8) /*!< Bytes used by a surface row */
+#define ILI9341_SURFACE_SIZE(width, height, bpp) (ILI9341_SURFACE_STRIDE(width, bpp) * (height)) /*!< Surface bytes */
+
 /* === Public data type declarations =========================================================== */
 
 /**
@@ -94,6 +100,45 @@ typedef enum {
     ILI9341_Landscape_2  /*!< Landscape orientation mode 2 */
 } ili9341_orientation_t;
 
+/**
+ * @brief  Pixel formats for RAM-resident sprites
+ */
+typedef enum {
+    ILI9341_SPRITE_RGB565,  /*!< One 16 bits RGB565 color per pixel */
+    ILI9341_SPRITE_INDEXED, /*!< One 8 bits palette index per pixel */
+} ili9341_sprite_format_t;
+
+/**
+ * @brief  Sprite stored in RAM with a transparent color key
+ */
+typedef struct {
+    uint16_t width;                 /*!< Sprite width in pixels */
+    uint16_t height;                /*!< Sprite height in pixels */
+    ili9341_sprite_format_t format; /*!< Format of the pixel data */
+    const void * data;              /*!< Row-major pixel data, RGB565 colors or palette indexes */
+    const uint16_t * palette;       /*!< RGB565 palette for indexed sprites, unused for RGB565 ones */
+    uint16_t key;                   /*!< Transparent color for RGB565 sprites, transparent index for indexed ones */
+} ili9341_sprite_t;
+
+/**
+ * @brief  Palette-indexed offscreen surface, expanded to RGB565 while it is transferred to the LCD
+ */
+typedef struct {
+    uint16_t width;      /*!< Surface width in pixels */
+    uint16_t height;     /*!< Surface height in pixels */
+    uint8_t bpp;         /*!< Bits per pixel: 1, 2, 4 or 8 */
+    uint8_t * data;      /*!< Palette indexes, rows packed from the most significant bit and padded to whole bytes */
+    uint16_t * palette;  /*!< RGB565 palette with 2^bpp entries */
+} ili9341_surface_t;
+
+/**
+ * @brief  Traffic sent to the LCD since the last @ref ILI9341ResetStats
+ */
+typedef struct {
+    uint32_t windows; /*!< Address windows set, one per rectangle, glyph, sprite or streamed area */
+    uint32_t bytes;   /*!< Data bytes sent, pixels and command parameters */
+} ili9341_stats_t;
+
 /* === Public variable declarations ============================================================ */
 
 /* === Public function declarations ============================================================ */
@@ -103,6 +148,47 @@ typedef enum {
  */
 void ILI9341Init(void);
 
+/**
+ * @brief  		Selects the fastest SPI clock that writes the LCD without errors
+ * @param[in]  	force: Run the calibration even if a previous result is stored in NVS
+ * @retval 		Selected frequency of sck in Hz
+ * @note        A test pattern is written at decreasing clock rates and read back from the frame memory. The
+ *              result is stored in NVS and reused on later boots, NVS must be initialized before
+ *              @ref ILI9341Init. Without NVS the calibration runs on every boot.
+ */
+int ILI9341Calibrate(bool force);
+
+/**
+ * @brief  		Reserves the SPI bus for a sequence of drawing calls
+ * @retval 		None
+ * @note        The touch controller and any other device of the bus wait until @ref ILI9341EndBatch, so the
+ *              sequence reaches the LCD without interleaved transactions. Batches can be nested, the bus is released
+ *              by the outermost end. Frame memory reads at a lower clock and the calibration can't run inside a
+ *              batch, because the clock of the LCD can't be changed while it holds the bus.
+ */
+void ILI9341StartBatch(void);
+
+/**
+ * @brief  		Ends a sequence started with @ref ILI9341StartBatch
+ * @retval 		None
+ */
+void ILI9341EndBatch(void);
+
+/**
+ * @brief  		Reads the traffic sent to the LCD since the last reset of the counters
+ * @param[out] 	stats: Counters of windows and bytes
+ * @retval 		None
+ * @note        The counters are meant to measure the cost of a drawing sequence, they are shared by all the tasks
+ *              that draw and aren't protected against concurrent updates.
+ */
+void ILI9341GetStats(ili9341_stats_t * stats);
+
+/**
+ * @brief  		Clears the traffic counters
+ * @retval 		None
+ */
+void ILI9341ResetStats(void);
+
 /**
  * @brief  		Draws single pixel to LCD
  * @param[in]  	x: X position for pixel
@@ -126,6 +212,14 @@ void ILI9341Fill(uint16_t color);
  */
 void ILI9341Rotate(ili9341_orientation_t orientation);
 
+/**
+ * @brief  		Inverts the colors shown on the LCD without changing the frame memory
+ * @param[in]	invert: true to show every pixel inverted, false to show the frame memory as it is
+ * @retval 		None
+ * @note        A single command changes the whole screen, the pixels drawn while it is inverted are shown inverted too
+ */
+void ILI9341Invert(bool invert);
+
 /**
  * @brief  		Draw a single character on the LCD
  * @param[in]  	x: X position of top left corner
@@ -224,6 +318,146 @@ void ILI9341DrawFilledCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
  */
 void ILI9341DrawPicture(uint16_t x, uint16_t y, uint16_t width, uint16_t hieght, const uint8_t * pic);
 
+/**
+ * @brief  		Reads a rectangle of the LCD frame memory
+ * @param[in]  	x0: X coordinate of top left point
+ * @param[in]  	y0: Y coordinate of top left point
+ * @param[in]  	x1: X coordinate of bottom right point
+ * @param[in]  	y1: Y coordinate of bottom right point
+ * @param[out] 	colors: Buffer for the RGB565 colors of the rectangle, row by row
+ * @retval 		ESP_OK if the rectangle was read
+ * @retval 		ESP_ERR_INVALID_STATE if called inside a batch, nothing is read
+ * @note        The read is done at a reduced SPI clock, the write clock is restored before returning. Reading is
+ *              much slower than drawing, a 138x51 rectangle takes about 28 ms of bus time against about 3 ms
+ *              to draw it again, so it is meant for checking the frame memory and not for moving its contents.
+ */
+esp_err_t ILI9341ReadRect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t * colors);
+
+/**
+ * @brief  		Opens a window of the LCD to stream its pixels with @ref ILI9341WriteColor
+ * @param[in]  	x0: X position of the top left corner of the window
+ * @param[in]  	y0: Y position of the top left corner of the window
+ * @param[in]  	x1: X position of the bottom right corner of the window
+ * @param[in]  	y1: Y position of the bottom right corner of the window
+ * @retval 		None
+ * @note        The pixels fill the window row by row. Nothing else can be drawn until @ref ILI9341EndArea.
+ */
+void ILI9341BeginArea(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+
+/**
+ * @brief  		Appends a run of pixels of the same color to the window opened with @ref ILI9341BeginArea
+ * @param[in]  	color: RGB565 color of the run
+ * @param[in]  	count: Number of pixels of the run, it may cross the end of the rows
+ * @retval 		None
+ * @note        The pixels are buffered and sent in chunks, the runs do not need to be aligned with them.
+ */
+void ILI9341WriteColor(uint16_t color, uint32_t count);
+
+/**
+ * @brief  		Sends the pixels still buffered and closes the window opened with @ref ILI9341BeginArea
+ * @retval 		None
+ */
+void ILI9341EndArea(void);
+
+/**
+ * @brief  		Draw a sprite on the LCD leaving transparent pixels untouched
+ * @param[in] 	x: X position of top left corner of sprite, may be outside the LCD
+ * @param[in]  	y: Y position of top left corner of sprite, may be outside the LCD
+ * @param[in] 	sprite: Pointer to sprite description
+ * @retval 		None
+ * @note        Each row is split in runs of opaque pixels and every run is sent in its own window, so the
+ *              sprite is clipped to the LCD and what lies under the transparent pixels is not redrawn.
+ */
+void ILI9341DrawSprite(int16_t x, int16_t y, const ili9341_sprite_t * sprite);
+
+/**
+ * @brief  		Initializes an offscreen surface over caller supplied memory
+ * @param[out] 	surface: Surface to initialize
+ * @param[in]  	width: Surface width in pixels
+ * @param[in]  	height: Surface height in pixels
+ * @param[in]  	bpp: Bits per pixel, must be 1, 2, 4 or 8
+ * @param[in]  	data: Memory for the pixels, at least ILI9341_SURFACE_SIZE(width, height, bpp) bytes
+ * @param[in]  	palette: Memory for the palette, 2^bpp RGB565 colors
+ * @retval 		None
+ * @note        A surface with zero width or height is valid, filling or flushing it does nothing.
+ */
+void ILI9341SurfaceInit(ili9341_surface_t * surface, uint16_t width, uint16_t height, uint8_t bpp, uint8_t * data,
+                        uint16_t * palette);
+
+/**
+ * @brief  		Changes a palette entry of a surface, the LCD is updated on the next flush
+ * @param[in]  	surface: Surface to modify
+ * @param[in]  	index: Palette entry
+ * @param[in]  	color: New RGB565 color for the entry
+ * @retval 		None
+ */
+void ILI9341SurfaceSetPalette(ili9341_surface_t * surface, uint8_t index, uint16_t color);
+
+/**
+ * @brief  		Sets a pixel of a surface
+ * @param[in]  	surface: Surface to modify
+ * @param[in]  	x: X position of the pixel in the surface
+ * @param[in]  	y: Y position of the pixel in the surface
+ * @param[in]  	index: Palette entry for the pixel
+ * @retval 		None
+ */
+void ILI9341SurfaceSetPixel(ili9341_surface_t * surface, uint16_t x, uint16_t y, uint8_t index);
+
+/**
+ * @brief  		Gets a pixel of a surface
+ * @param[in]  	surface: Surface to read
+ * @param[in]  	x: X position of the pixel in the surface
+ * @param[in]  	y: Y position of the pixel in the surface
+ * @retval 		Palette entry of the pixel
+ */
+uint8_t ILI9341SurfaceGetPixel(const ili9341_surface_t * surface, uint16_t x, uint16_t y);
+
+/**
+ * @brief  		Fills a rectangle of a surface, clipped to the surface
+ * @param[in]  	surface: Surface to modify
+ * @param[in]  	x0: X coordinate of top left point
+ * @param[in]  	y0: Y coordinate of top left point
+ * @param[in]  	x1: X coordinate of bottom right point
+ * @param[in]  	y1: Y coordinate of bottom right point
+ * @param[in]  	index: Palette entry for the rectangle
+ * @retval 		None
+ */
+void ILI9341SurfaceFillRectangle(ili9341_surface_t * surface, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1,
+                                 uint8_t index);
+
+/**
+ * @brief  		Composites an indexed sprite into a surface, skipping the transparent index
+ * @param[in]  	surface: Surface to modify
+ * @param[in] 	x: X position of top left corner of sprite in the surface, may be outside it
+ * @param[in]  	y: Y position of top left corner of sprite in the surface, may be outside it
+ * @param[in] 	sprite: Indexed sprite, its indexes refer to the surface palette
+ * @retval 		None
+ */
+void ILI9341SurfaceDrawSprite(ili9341_surface_t * surface, int16_t x, int16_t y, const ili9341_sprite_t * sprite);
+
+/**
+ * @brief  		Sends an area of a surface to the LCD expanding the palette on the fly
+ * @param[in]  	surface: Surface to send
+ * @param[in]  	x: X position on the LCD of the surface top left corner
+ * @param[in]  	y: Y position on the LCD of the surface top left corner
+ * @param[in]  	x0: X coordinate in the surface of top left point of the area
+ * @param[in]  	y0: Y coordinate in the surface of top left point of the area
+ * @param[in]  	x1: X coordinate in the surface of bottom right point of the area
+ * @param[in]  	y1: Y coordinate in the surface of bottom right point of the area
+ * @retval 		None
+ */
+void ILI9341SurfaceFlushArea(const ili9341_surface_t * surface, uint16_t x, uint16_t y, uint16_t x0, uint16_t y0,
+                             uint16_t x1, uint16_t y1);
+
+/**
+ * @brief  		Sends a whole surface to the LCD expanding the palette on the fly
+ * @param[in]  	surface: Surface to send
+ * @param[in]  	x: X position on the LCD of the surface top left corner
+ * @param[in]  	y: Y position on the LCD of the surface top left corner
+ * @retval 		None
+ */
+void ILI9341SurfaceFlush(const ili9341_surface_t * surface, uint16_t x, uint16_t y);
+
 /* === End of documentation ==================================================================== */
 
 #ifdef __cplusplus
@@ -38,11 +38,13 @@ SPDX-License-Identifier: MIT
 #include "display.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
+#include "nvs_flash.h"
 #include "teclas.h"
 #include "leds.h"
 #include "time_struct.h"
 #include "string.h"
 #include "mode_op.h"
+#include "xpt2046.h"
 /* === Macros definitions =========================================================================================== */
 
 #define LED_ROJO GPIO_NUM_26
@@ -64,16 +66,17 @@ SPDX-License-Identifier: MIT
 #define BLINK 1 << 3
 #define RED 1 << 4
 #define CUENTA 1 << 5
-#define RESET_PANTALLA 1 << 6
+#define VER_ESTADISTICAS 1 << 6 // muestra las estadisticas de las vueltas en lugar de las vueltas
 #define TOMAR_PARCIAL 1 << 7
 #define EN_PAUSA 1 << 8
 #define RESET 1 << 16
+#define VER_VUELTAS 1 << 17 // desplaza la ventana de vueltas con el cronometro en pausa
+#define VER_ANALOGICO 1 << 18 // muestra el reloj con agujas en lugar de digitos
 
 #define BOTON_MODO 1 << 9
 
-#define QUEUE_LENGTH 10
+#define QUEUE_LENGTH 1 // la pantalla solo dibuja el último valor, el productor lo reemplaza sin esperar
 
-#define QUEUE_LENGTH_C 10
 #define ITEM_SIZE sizeof(time_struct)
 
 /* === Private data type declarations =============================================================================== */
@@ -84,8 +87,9 @@ SPDX-License-Identifier: MIT
 typedef struct crono_task
 {
     time_struct_t time;
+    vueltas_t vueltas;
     EventGroupHandle_t event_group;
-    QueueHandle_t handler_time;
+    QueueHandle_t handler_time, handler_vueltas;
     int estado;
 } crono_task;
 
@@ -140,6 +144,10 @@ void printbin(unsigned long n)
  * It also handles pausing/resuming via `EN_PAUSA` and sends time updates to the
  * display task via a queue only when in `MODO_CRONO`.
  *
+ * The task owns the laps: `TOMAR_PARCIAL` stores the current time in the ring buffer, and
+ * `VER_VUELTAS` moves the window of laps shown while the stopwatch is paused. The window goes
+ * back to the newest laps when a lap is taken or the stopwatch resumes.
+ *
  * @param args A pointer to a `crono_task_t` structure containing stopwatch state and queue handles.
  */
 void contar_decima(void *args)
@@ -147,15 +155,21 @@ void contar_decima(void *args)
     crono_task_t cronometro_p = (crono_task_t)args;
     EventGroupHandle_t _event_group = cronometro_p->event_group;
     QueueHandle_t qHandle = cronometro_p->handler_time;
+    QueueHandle_t qVueltas = cronometro_p->handler_vueltas;
     TickType_t lastEvent;
     time_struct_t cronometro = cronometro_p->time;
+    vueltas_t vueltas = cronometro_p->vueltas;
+    vista_vueltas vista;
+    int desplazamiento = 0;
     time_cero(cronometro);
+    vueltas_cero(vueltas);
     lastEvent = xTaskGetTickCount();
 
     while (1)
     {
         // desición de diseño: esto es independiente del modo
-        EventBits_t wBits = xEventGroupWaitBits(_event_group, CUENTA | RESET | EN_PAUSA, pdFALSE, pdFALSE, portMAX_DELAY);
+        EventBits_t wBits = xEventGroupWaitBits(_event_group, CUENTA | RESET | EN_PAUSA | VER_VUELTAS, pdFALSE, pdFALSE,
+                                                portMAX_DELAY);
         //     ESP_LOGI(TAG, "Estado de los bits en contar_decima: %lu", wBits);
 
         if ((wBits & CUENTA) != 0)
@@ -165,6 +179,13 @@ void contar_decima(void *args)
             {
                 xEventGroupClearBits(_event_group, EN_PAUSA);
                 lastEvent = xTaskGetTickCount();
+                if (desplazamiento != 0)
+                {
+                    desplazamiento = 0;
+                    vueltas_vista(vueltas, desplazamiento, &vista);
+                    xQueueOverwrite(qVueltas, &vista);
+                    pantalla_notificar();
+                }
             }
             // ESP_LOGI(TAG, "CUENTA activado - Tick actual: %lu, Last Event: %lu", xTaskGetTickCount(), lastEvent);
             /*  ESP_LOGI(TAG, "time: %d %d %d.%d", cronometro->centena,
@@ -172,6 +193,16 @@ void contar_decima(void *args)
                                           cronometro->decima
                                   );*/
             time_tick(cronometro);
+            if ((wBits & TOMAR_PARCIAL) != 0)
+            {
+                // agregar una vuelta no mueve las anteriores, la pantalla recibe solo las filas visibles
+                vueltas_agregar(vueltas, *cronometro);
+                xEventGroupClearBits(_event_group, TOMAR_PARCIAL);
+                desplazamiento = 0;
+                vueltas_vista(vueltas, desplazamiento, &vista);
+                xQueueOverwrite(qVueltas, &vista);
+                pantalla_notificar();
+            }
             switch (wBits & (MODOS))
             {
             case MODO_CLOCK_CONF:
@@ -183,7 +214,8 @@ void contar_decima(void *args)
             case MODO_ALARM_CONF:
                 break;
             case MODO_CRONO:
-                xQueueSend(qHandle, cronometro, portMAX_DELAY);
+                xQueueOverwrite(qHandle, cronometro);
+                pantalla_notificar();
                 break;
             default:
                 break;
@@ -204,8 +236,12 @@ void contar_decima(void *args)
                 break;
             case MODO_CRONO:
                 time_cero(cronometro);
-                xEventGroupSetBits(_event_group, RESET_PANTALLA);
-                xQueueSend(qHandle, cronometro, portMAX_DELAY);
+                vueltas_cero(vueltas);
+                desplazamiento = 0;
+                vueltas_vista(vueltas, desplazamiento, &vista);
+                xQueueOverwrite(qHandle, cronometro);
+                xQueueOverwrite(qVueltas, &vista);
+                pantalla_notificar();
                 xEventGroupClearBits(_event_group, RESET);
 
                 break;
@@ -214,6 +250,15 @@ void contar_decima(void *args)
             }
         }
 
+        if ((wBits & VER_VUELTAS) != 0)
+        {
+            xEventGroupClearBits(_event_group, VER_VUELTAS);
+            desplazamiento = vueltas_desplazar(vueltas, desplazamiento);
+            vueltas_vista(vueltas, desplazamiento, &vista);
+            xQueueOverwrite(qVueltas, &vista);
+            pantalla_notificar();
+        }
+
         vTaskDelayUntil(&lastEvent, pdMS_TO_TICKS(100));
     }
 }
@@ -255,18 +300,23 @@ void contar_segundos(void *args)
         case MODO_CLOCK_CONF:
             conf.select = clock_p->selected;
             conf.t = clock_p->clock;
-            xQueueSend(qconf, &conf, pdMS_TO_TICKS(2));
+            xQueueOverwrite(qconf, &conf);
+            pantalla_notificar();
             break;
         case MODO_CLOCK:
-            xQueueSend(qHandle, clock, pdMS_TO_TICKS(2)); // MODO CLOCK, envío el tiempo a la pantalla
+            xQueueOverwrite(qHandle, clock); // MODO CLOCK, envío el tiempo a la pantalla
+            pantalla_notificar();
             break;
         case MODO_CRONO:
             break;
         case MODO_ALARM_CONF:
-            xQueueSend(qHandle_alarm, clock_p->alarm, pdMS_TO_TICKS(2));
+            xQueueOverwrite(qHandle_alarm, clock_p->alarm);
+            pantalla_notificar();
             break;
         case MODO_ALARM:
             ESP_LOGI(TAG_ALARM, "¡ALARMA SONANDO!");
+            xQueueOverwrite(qHandle, clock); // el reloj sigue en la pantalla mientras destella
+            pantalla_notificar();
 
             break;
         default:
@@ -314,7 +364,8 @@ void tarea_b1(void *args)
                     xEventGroupClearBits(_event_group, BOTON_1);
                     conf.select = clock_p->selected;
                     conf.t = clock_p->clock;
-                    xQueueSend(qconf, &conf, pdMS_TO_TICKS(0));
+                    xQueueOverwrite(qconf, &conf);
+                    pantalla_notificar();
                 }
                 break;
             case MODO_ALARM_CONF:
@@ -327,7 +378,8 @@ void tarea_b1(void *args)
                     xEventGroupClearBits(_event_group, BOTON_1);
                     conf.select = clock_p->alarm->select;
                     conf.t = clock_p->alarm->t;
-                    xQueueSend(qalarm, &conf, pdMS_TO_TICKS(0));
+                    xQueueOverwrite(qalarm, &conf);
+                    pantalla_notificar();
                 }
                 break;
 
@@ -342,6 +394,7 @@ void tarea_b1(void *args)
                     xEventGroupClearBits(_event_group, BLINK);
                     xEventGroupSetBits(_event_group, EN_PAUSA);
                     xEventGroupSetBits(_event_group, RED);
+                    pantalla_notificar();
                 }
                 else if ((wBits & BOTON_ESTADO) != 0)
                 {
@@ -350,6 +403,7 @@ void tarea_b1(void *args)
                     xEventGroupClearBits(_event_group, BOTON_ESTADO); // BOTON_1
                     xEventGroupClearBits(_event_group, RED);
                     xEventGroupClearBits(_event_group, BOTON_BORRAR);
+                    pantalla_notificar();
                 }
                 break;
             default:
@@ -398,7 +452,8 @@ void tarea_b2(void *args)
                     conf.select = clock_p->selected;
                     conf.t = clock_p->clock;
                     xEventGroupClearBits(_event_group, BOTON_2);
-                    xQueueSend(qconf, &conf, pdMS_TO_TICKS(10));
+                    xQueueOverwrite(qconf, &conf);
+                    pantalla_notificar();
                     
                 }
                 break;
@@ -410,7 +465,8 @@ void tarea_b2(void *args)
                     printbin(wBits);
                     clock_decrementar_campo(clock_p->alarm->t, clock_p->alarm->select);
                     xEventGroupClearBits(_event_group, BOTON_2);
-                    xQueueSend(qHandle_alarm, clock_p->alarm, pdMS_TO_TICKS(10));
+                    xQueueOverwrite(qHandle_alarm, clock_p->alarm);
+                    pantalla_notificar();
                 }
                 break;
             case MODO_ALARM: // alarma sonando
@@ -445,6 +501,8 @@ void tarea_b2(void *args)
                     default:
                         break;
                     }
+                    xEventGroupSetBits(_event_group, CAMBIO_MODO); // vuelve a la pantalla del modo anterior
+                    pantalla_notificar();
                 }
                 break;
             case MODO_CRONO:
@@ -474,7 +532,8 @@ void tarea_b2(void *args)
  * - In **Clock Configuration** mode: Increments the currently selected clock time field.
  * - In **Alarm (sounding)** mode: Snoozes the alarm for 5 minutes.
  * - In **Alarm Configuration** mode: Increments the currently selected alarm time field.
- * - In **Stopwatch** mode: Records a lap (partial) time if the stopwatch is running.
+ * - In **Stopwatch** mode: Records a lap (partial) time if the stopwatch is running, or scrolls
+ * the laps shown if it is paused.
  *
  * @param args A pointer to a `clock_task_t` structure for accessing clock/alarm data and event group.
  */
@@ -499,7 +558,8 @@ void tarea_b3(void *args)
                 xEventGroupClearBits(_event_group, BOTON_3);
                 conf.select = clock_p->selected;
                 conf.t = clock_p->clock;
-                xQueueSend(qHandle, &conf, pdMS_TO_TICKS(10));
+                xQueueOverwrite(qHandle, &conf);
+                pantalla_notificar();
             }
 
             break;
@@ -536,6 +596,8 @@ void tarea_b3(void *args)
                 default:
                     break;
                 }
+                xEventGroupSetBits(_event_group, CAMBIO_MODO); // vuelve a la pantalla del modo anterior
+                pantalla_notificar();
             }
             break;
         case MODO_ALARM_CONF:
@@ -545,7 +607,8 @@ void tarea_b3(void *args)
                 printbin(wBits);
                 clock_incrementar_campo(clock_p->alarm->t, clock_p->alarm->select);
                 xEventGroupClearBits(_event_group, BOTON_3);
-                xQueueSend(qHandle_alarm, clock_p->alarm, pdMS_TO_TICKS(10));
+                xQueueOverwrite(qHandle_alarm, clock_p->alarm);
+                pantalla_notificar();
             }
             break;
         case MODO_CRONO:
@@ -556,6 +619,13 @@ void tarea_b3(void *args)
 
                 xEventGroupSetBits(_event_group, TOMAR_PARCIAL);
                 xEventGroupClearBits(_event_group, BOTON_PARCIAL); // BOTON_3
+                pantalla_notificar();
+            }
+            else if ((wBits & BOTON_3) != 0)
+            {
+                // en pausa el boton recorre las vueltas guardadas
+                xEventGroupSetBits(_event_group, VER_VUELTAS);
+                xEventGroupClearBits(_event_group, BOTON_PARCIAL); // BOTON_3
             }
             break;
         default:
@@ -568,6 +638,90 @@ void tarea_b3(void *args)
     }
 }
 
+/**
+ * @brief FreeRTOS task handling the touch panel.
+ *
+ * In **Clock Configuration** and **Alarm Configuration** modes, touching a field of the clock
+ * selects it directly, instead of cycling through the fields with Button 1. The task samples the
+ * panel with a higher priority than the display task, so the samples are taken between two SPI
+ * transfers of the display. A new selection needs the panel to be released first.
+ *
+ * In **Clock** mode, touching anywhere switches between the clock with digits and with hands, and in
+ * **Stopwatch** mode between the laps and their statistics.
+ *
+ * @param args A pointer to a `clock_task_t` structure for accessing clock/alarm data and event group.
+ */
+void tarea_touch(void *args)
+{
+    clock_task_t clock_p = (clock_task_t)args;
+    EventGroupHandle_t _event_group = clock_p->event_group;
+    QueueHandle_t qconf = clock_p->handler_conf;
+    QueueHandle_t qalarm = clock_p->handler_alarm;
+    clock_settings conf;
+    xpt2046_point_t punto;
+    bool presionado = false;
+    int campo;
+
+    while (1)
+    {
+        vTaskDelay(pdMS_TO_TICKS(20));
+        if (!XPT2046Read(&punto))
+        {
+            presionado = false;
+            continue;
+        }
+        if (presionado)
+        {
+            continue;
+        }
+        presionado = true;
+
+        campo = campo_en_pantalla(punto.x, punto.y);
+        EventBits_t wBits = xEventGroupGetBits(_event_group);
+        switch (wBits & (MODOS))
+        {
+        case MODO_CLOCK:
+            // tocar la pantalla alterna entre el reloj con digitos y con agujas
+            if ((wBits & VER_ANALOGICO) != 0)
+                xEventGroupClearBits(_event_group, VER_ANALOGICO);
+            else
+                xEventGroupSetBits(_event_group, VER_ANALOGICO);
+            xEventGroupSetBits(_event_group, CAMBIO_MODO);
+            pantalla_notificar();
+            break;
+        case MODO_CRONO:
+            // tocar la pantalla alterna entre las vueltas y sus estadisticas
+            if ((wBits & VER_ESTADISTICAS) != 0)
+                xEventGroupClearBits(_event_group, VER_ESTADISTICAS);
+            else
+                xEventGroupSetBits(_event_group, VER_ESTADISTICAS);
+            xEventGroupSetBits(_event_group, CAMBIO_MODO);
+            pantalla_notificar();
+            break;
+        case MODO_CLOCK_CONF:
+            if (campo < 0)
+                break;
+            clock_p->selected = campo;
+            conf.select = clock_p->selected;
+            conf.t = clock_p->clock;
+            xQueueOverwrite(qconf, &conf);
+            pantalla_notificar();
+            break;
+        case MODO_ALARM_CONF:
+            if (campo < 0)
+                break;
+            clock_p->alarm->select = campo;
+            conf.select = clock_p->alarm->select;
+            conf.t = clock_p->alarm->t;
+            xQueueOverwrite(qalarm, &conf);
+            pantalla_notificar();
+            break;
+        default:
+            break;
+        }
+    }
+}
+
 /**
  * @brief FreeRTOS task handling Button 4 (`BOTON_MODO`) for changing operational modes.
  *
@@ -596,6 +750,7 @@ void cambia_modo(void *args)
                 xEventGroupSetBits(_event_group, MODO_CLOCK_CONF);
                 xEventGroupClearBits(_event_group, BOTON_MODO);
                 xEventGroupSetBits(_event_group, CAMBIO_MODO);
+                pantalla_notificar();
                 ESP_LOGI(TAG, "¡CAMBIA A MODO CLOCK_CONF!");
             }
             break;
@@ -607,6 +762,7 @@ void cambia_modo(void *args)
                 xEventGroupSetBits(_event_group, MODO_ALARM_CONF);
                 xEventGroupClearBits(_event_group, BOTON_MODO);
                 xEventGroupSetBits(_event_group, CAMBIO_MODO);
+                pantalla_notificar();
                 ESP_LOGI(TAG, "¡CAMBIA A MODO ALARM CONF!");
             }
             break;
@@ -621,6 +777,7 @@ void cambia_modo(void *args)
                 xEventGroupSetBits(_event_group, MODO_CRONO);
                 xEventGroupClearBits(_event_group, BOTON_MODO);
                 xEventGroupSetBits(_event_group, CAMBIO_MODO);
+                pantalla_notificar();
                 ESP_LOGI(TAG, "¡CAMBIA A MODO CRONO!");
                 EventBits_t current_state_bits = xEventGroupGetBits(_event_group); 
                 if ((current_state_bits & CUENTA) != 0) 
@@ -633,9 +790,11 @@ void cambia_modo(void *args)
             if ((wBits & BOTON_MODO) != 0)
             {
                 xEventGroupClearBits(_event_group, MODO_CRONO);
+                xEventGroupClearBits(_event_group, VER_ESTADISTICAS);
                 xEventGroupSetBits(_event_group, MODO_CLOCK);
                 xEventGroupClearBits(_event_group, BOTON_MODO);
                 xEventGroupSetBits(_event_group, CAMBIO_MODO);
+                pantalla_notificar();
                 xEventGroupClearBits(_event_group, BLINK);
                 xEventGroupClearBits(_event_group, RED);
 
@@ -707,6 +866,8 @@ void dispara_alarma(void *args)
                 xEventGroupClearBits(_event_group, MODOS);
                 xEventGroupSetBits(_event_group, BLINK);
                 xEventGroupSetBits(_event_group, MODO_ALARM);
+                xEventGroupSetBits(_event_group, CAMBIO_MODO); // la alarma se muestra sobre el reloj
+                pantalla_notificar();
                 ESP_LOGI(TAG_ALARM, "¡ALARMA SONANDO!");
             }
         }
@@ -723,6 +884,7 @@ void dispara_alarma(void *args)
  * - A `contar_segundos` task for the main clock.
  * - A `dispara_alarma` task for alarm handling.
  * - Three `tarea_bX` tasks for specific button functionalities (B1, B2, B3).
+ * - A `tarea_touch` task for selecting configuration fields on the touch panel.
  * - A `cambia_modo` task for mode switching.
  * - A `contar_decima` task for the stopwatch.
  * - A `dibujar_pantalla` task for display management.
@@ -738,16 +900,27 @@ void app_main(void)
     display_task_t display_args;
     EventGroupHandle_t event_group = xEventGroupCreate();
 
+    // la calibración del reloj SPI de la pantalla se guarda en NVS
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND)
+    {
+        ESP_ERROR_CHECK(nvs_flash_erase());
+        ret = nvs_flash_init();
+    }
+    ESP_ERROR_CHECK(ret);
+
     static StaticQueue_t xDisplayQueue_crono;
     static StaticQueue_t xDisplayQueue_alarm;        // clock + campo
     static StaticQueue_t xDisplayQueue_clock;        // clock
     static StaticQueue_t xDisplayQueue_clock_config; // clock + campo
+    static StaticQueue_t xDisplayQueue_vueltas;      // vueltas visibles
 
-    uint8_t buffer_display[QUEUE_LENGTH * ITEM_SIZE];
+    static uint8_t buffer_display[QUEUE_LENGTH * ITEM_SIZE];
 
-    uint8_t buffer_display_c[QUEUE_LENGTH_C * sizeof(time_clock)];
-    uint8_t buffer_display_a[QUEUE_LENGTH_C * sizeof(clock_settings)];
-    uint8_t buffer_display_conf[QUEUE_LENGTH_C * sizeof(clock_settings)];
+    static uint8_t buffer_display_c[QUEUE_LENGTH * sizeof(time_clock)];
+    static uint8_t buffer_display_a[QUEUE_LENGTH * sizeof(clock_settings)];
+    static uint8_t buffer_display_conf[QUEUE_LENGTH * sizeof(clock_settings)];
+    static uint8_t buffer_display_v[QUEUE_LENGTH * sizeof(vista_vueltas)];
 
     QueueHandle_t q_crono = xQueueCreateStatic(QUEUE_LENGTH,
                                                ITEM_SIZE,
@@ -758,14 +931,18 @@ void app_main(void)
                                                buffer_display_c,
                                                &xDisplayQueue_clock);
 
-    QueueHandle_t q_clock_conf = xQueueCreateStatic(QUEUE_LENGTH_C,
+    QueueHandle_t q_clock_conf = xQueueCreateStatic(QUEUE_LENGTH,
                                                     sizeof(clock_settings),
                                                     buffer_display_conf,
                                                     &xDisplayQueue_clock_config);
-    QueueHandle_t q_alarm = xQueueCreateStatic(QUEUE_LENGTH_C,
+    QueueHandle_t q_alarm = xQueueCreateStatic(QUEUE_LENGTH,
                                                sizeof(clock_settings),
                                                buffer_display_a,
                                                &xDisplayQueue_alarm);
+    QueueHandle_t q_vueltas = xQueueCreateStatic(QUEUE_LENGTH,
+                                                 sizeof(vista_vueltas),
+                                                 buffer_display_v,
+                                                 &xDisplayQueue_vueltas);
     // eventos del estado inicial
     //  xEventGroupSetBits(event_group, RED);
     xEventGroupSetBits(event_group, MODO_CLOCK);
@@ -843,12 +1020,17 @@ void app_main(void)
         if (xTaskCreate(tarea_b3, "parcial", 20 * 1024, clock_args, tskIDLE_PRIORITY, NULL) != pdPASS)
             ESP_LOGE(TAG, "Fallo al crear parcial/B3 ");
 
+        if (xTaskCreate(tarea_touch, "touch", 2 * 1024, clock_args, tskIDLE_PRIORITY + 3, NULL) != pdPASS)
+            ESP_LOGE(TAG, "Fallo al crear touch");
+
         if (xTaskCreate(cambia_modo, "modo", 2 * 1024, event_group, tskIDLE_PRIORITY, NULL) != pdPASS)
             ESP_LOGE(TAG, "Fallo al crear modo/B4 ");
         crono_args = malloc(sizeof(crono_task));
         crono_args->time = malloc(sizeof(time_struct));
+        crono_args->vueltas = malloc(sizeof(vueltas));
         crono_args->event_group = event_group;
         crono_args->handler_time = q_crono;
+        crono_args->handler_vueltas = q_vueltas;
         crono_args->estado = 0;
         if (xTaskCreate(contar_decima, "contar", 3 * 1024, crono_args, tskIDLE_PRIORITY + 3, NULL) != pdPASS)
             ESP_LOGE(TAG, "Fallo al crear contar");
@@ -858,10 +1040,12 @@ void app_main(void)
         display_args->qclock = q_clock;
         display_args->qalarm = q_alarm;
         display_args->qconf = q_clock_conf;
+        display_args->qvueltas = q_vueltas;
         display_args->selected = 0;
         display_args->event_group = event_group;
-        display_args->parcial_bits = TOMAR_PARCIAL;
-        display_args->reset_bits = RESET_PANTALLA;
+        display_args->cuenta_bits = CUENTA;
+        display_args->estadisticas_bits = VER_ESTADISTICAS;
+        display_args->analogico_bits = VER_ANALOGICO;
         if (xTaskCreate(dibujar_pantalla, "pantalla", 54 * 1024, display_args, tskIDLE_PRIORITY + 2, NULL) != pdPASS)
             ESP_LOGE(TAG, "Fallo al crear pantalla");
     }
@@ -91,6 +91,105 @@ void time_incrementar_segundo(time_struct_t timer, digito_t digito_inicial)
     }
 }
 
+int time_decimas(const time_struct *timer)
+{
+    return timer->centena * 1000 + timer->decena * 100 + timer->unidad * 10 + timer->decima;
+}
+
+void vueltas_cero(vueltas_t laps)
+{
+    laps->siguiente = 0;
+    laps->cantidad = 0;
+    laps->total = 0;
+    laps->estadisticas = (estadisticas_vueltas){0};
+}
+
+void vueltas_agregar(vueltas_t laps, time_struct vuelta)
+{
+    estadisticas_vueltas *estadisticas = &(laps->estadisticas);
+    int anterior = 0, duracion;
+    float diferencia;
+
+    // la vuelta dura desde el parcial anterior, que es el más nuevo del anillo
+    if (laps->cantidad > 0)
+    {
+        anterior = time_decimas(&(laps->registros[(laps->siguiente - 1 + VUELTAS_CAPACIDAD) % VUELTAS_CAPACIDAD]));
+    }
+    // el cronometro vuelve a cero a los 1000 segundos
+    duracion = (time_decimas(&vuelta) - anterior + 10000) % 10000;
+
+    // media y suma de cuadrados por el método de Welford, sin recorrer las vueltas anteriores
+    estadisticas->cantidad++;
+    diferencia = duracion - estadisticas->media;
+    estadisticas->media += diferencia / estadisticas->cantidad;
+    estadisticas->m2 += diferencia * (duracion - estadisticas->media);
+    if ((estadisticas->cantidad == 1) || (duracion < estadisticas->mejor))
+    {
+        estadisticas->mejor = duracion;
+        estadisticas->numero_mejor = laps->total + 1;
+    }
+    if ((estadisticas->cantidad == 1) || (duracion > estadisticas->peor))
+    {
+        estadisticas->peor = duracion;
+        estadisticas->numero_peor = laps->total + 1;
+    }
+    estadisticas->delta = (estadisticas->cantidad == 1) ? 0 : duracion - estadisticas->ultima;
+    estadisticas->ultima = duracion;
+
+    laps->registros[laps->siguiente] = vuelta;
+    laps->siguiente = (laps->siguiente + 1) % VUELTAS_CAPACIDAD;
+    if (laps->cantidad < VUELTAS_CAPACIDAD)
+    {
+        laps->cantidad++;
+    }
+    laps->total++;
+}
+
+void vueltas_vista(vueltas_t laps, int desplazamiento, vista_vueltas *vista)
+{
+    int posicion;
+
+    vista->primera = laps->total - desplazamiento;
+    vista->desplazada = (desplazamiento > 0);
+    vista->mejor = -1;
+    vista->peor = -1;
+    for (int fila = 0; fila < VUELTAS_VISIBLES; fila++)
+    {
+        if (desplazamiento + fila < laps->cantidad)
+        {
+            // la vuelta más nueva está justo antes de la siguiente posición del anillo
+            posicion = (laps->siguiente - 1 - desplazamiento - fila + 2 * VUELTAS_CAPACIDAD) % VUELTAS_CAPACIDAD;
+            vista->filas[fila] = laps->registros[posicion];
+
+            // con una sola vuelta no hay mejor ni peor para resaltar
+            if ((laps->estadisticas.cantidad > 1) && (vista->primera - fila == laps->estadisticas.numero_mejor))
+            {
+                vista->mejor = fila;
+            }
+            if ((laps->estadisticas.cantidad > 1) && (vista->primera - fila == laps->estadisticas.numero_peor))
+            {
+                vista->peor = fila;
+            }
+        }
+        else
+        {
+            time_cero(&(vista->filas[fila]));
+        }
+    }
+    vista->estadisticas = laps->estadisticas;
+}
+
+int vueltas_desplazar(const vueltas *laps, int desplazamiento)
+{
+    // la ventana baja una vuelta y al llegar a la más vieja vuelve a las más nuevas
+    return (desplazamiento + VUELTAS_VISIBLES < laps->cantidad) ? desplazamiento + 1 : 0;
+}
+
+float vueltas_varianza(const estadisticas_vueltas *estadisticas)
+{
+    return (estadisticas->cantidad > 1) ? estadisticas->m2 / (estadisticas->cantidad - 1) : 0;
+}
+
 void time_tick(time_struct_t timer)
 {
     timer->decima++;
@@ -74,6 +74,57 @@ typedef struct clock_settings{
  */
 typedef struct clock_settings *clock_settings_t;
 
+#define VUELTAS_CAPACIDAD 100 /**< Laps kept by the stopwatch, a new lap replaces the oldest one. */
+#define VUELTAS_VISIBLES 3    /**< Laps shown at the same time on the display. */
+
+/**
+ * @brief Running statistics of the lap times, updated with each lap without going over the stored ones.
+ * A lap time is the split taken minus the previous split.
+ */
+typedef struct estadisticas_vueltas
+{
+    int cantidad;     /**< Laps measured since the stopwatch was reset. */
+    int mejor;        /**< Shortest lap, in tenths of a second. */
+    int peor;         /**< Longest lap, in tenths of a second. */
+    int numero_mejor; /**< Number of the shortest lap, 0 without laps. */
+    int numero_peor;  /**< Number of the longest lap, 0 without laps. */
+    float media;      /**< Mean lap, in tenths of a second. */
+    float m2;         /**< Sum of the squared differences from the mean, updated with Welford's method. */
+    int ultima;       /**< Last lap, in tenths of a second. */
+    int delta;        /**< Last lap minus the previous one, in tenths of a second, 0 for the first lap. */
+} estadisticas_vueltas;
+
+/**
+ * @brief Ring buffer with the laps of the stopwatch.
+ * Adding a lap doesn't move the stored ones, it only writes the next position of the ring.
+ */
+typedef struct vueltas
+{
+    time_struct registros[VUELTAS_CAPACIDAD]; /**< Lap times, in the order they were taken. */
+    int siguiente;                            /**< Position of the next lap in the ring. */
+    int cantidad;                             /**< Laps stored, up to VUELTAS_CAPACIDAD. */
+    int total;                                /**< Laps taken since the stopwatch was reset, numbers the laps. */
+    estadisticas_vueltas estadisticas;        /**< Statistics of all the laps taken, stored or not. */
+} vueltas;
+
+/**
+ * @brief Pointer to a `vueltas` ring buffer.
+ */
+typedef struct vueltas *vueltas_t;
+
+/**
+ * @brief Laps shown on the display, a window over the ring buffer.
+ */
+typedef struct vista_vueltas
+{
+    time_struct filas[VUELTAS_VISIBLES]; /**< Lap times from the newest shown, zero past the oldest stored lap. */
+    int primera;                         /**< Number of the lap in the first row, 0 without laps. */
+    bool desplazada;                     /**< The window doesn't start at the newest lap. */
+    int mejor;                           /**< Row of the shortest lap, -1 if it isn't shown. */
+    int peor;                            /**< Row of the longest lap, -1 if it isn't shown. */
+    estadisticas_vueltas estadisticas;   /**< Statistics of all the laps. */
+} vista_vueltas;
+
 
 
 /**
@@ -97,6 +148,49 @@ void time_tick(time_struct_t timer);
  */
 void time_incrementar_segundo(time_struct_t timer, digito_t digito_inicial);
 
+/**
+ * @brief Converts a stopwatch time to tenths of a second.
+ * @param timer Pointer to the `time_struct` to convert.
+ * @return The time in tenths of a second.
+ */
+int time_decimas(const time_struct *timer);
+
+/**
+ * @brief Removes all the laps of a ring buffer and clears their statistics.
+ * @param laps Pointer to the ring buffer to be emptied.
+ */
+void vueltas_cero(vueltas_t laps);
+
+/**
+ * @brief Stores a lap in a ring buffer, replacing the oldest one when the buffer is full, and updates the
+ * statistics in constant time.
+ * @param laps Pointer to the ring buffer.
+ * @param vuelta Split time of the lap.
+ */
+void vueltas_agregar(vueltas_t laps, time_struct vuelta);
+
+/**
+ * @brief Fills the window of laps shown on the display.
+ * @param laps Pointer to the ring buffer.
+ * @param desplazamiento Laps skipped from the newest one, 0 for the newest laps.
+ * @param vista Pointer to the window to fill.
+ */
+void vueltas_vista(vueltas_t laps, int desplazamiento, vista_vueltas *vista);
+/**
+ * @brief Moves the window of laps one lap towards the oldest one, going back to the newest laps after the oldest.
+ * @param laps Pointer to the ring buffer.
+ * @param desplazamiento Laps skipped from the newest one by the current window.
+ * @return Laps skipped by the next window.
+ */
+int vueltas_desplazar(const vueltas *laps, int desplazamiento);
+
+/**
+ * @brief Computes the sample variance of the lap times from their running statistics.
+ * @param estadisticas Pointer to the statistics.
+ * @return The variance, in tenths of a second squared, 0 with less than two laps.
+ */
+float vueltas_varianza(const estadisticas_vueltas *estadisticas);
+
 /**
  * @brief Initializes a `time_clock` structure to a default start time (e.g., 2025/01/01 00:00:00).
  * @param timer Pointer to the `time_clock` to be initialized.
@@ -0,0 +1,199 @@
+/************************************************************************************************
+Copyright (c) 2025, Erica Vidal <ericavidal@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial
+portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*************************************************************************************************/
+
+/** @file xpt2046.c
+ ** @brief Definiciones de la biblioteca para el controlador táctil XPT2046 que comparte el bus SPI con el ILI9341
+ **
+ ** The controller is attached as a second device of the LCD SPI host. The SPI master driver serializes the
+ ** transactions of both devices: the LCD sends every chunk of pixels as its own transaction, so a touch batch
+ ** can only run between two chunks and never splits one. Frame memory reads and the drawing batches of the LCD
+ ** hold the bus until they end.
+ ** The task that samples the touch must have a higher priority than the one that draws, so a pending sample
+ ** is taken at the next chunk boundary instead of waiting for the whole drawing.
+ ** The host test test/test_arbitraje.c reads the touch while the LCD draws batches on a simulated bus, and checks
+ ** that no touch transaction lands inside a batch.
+ **/
+
+/* === Headers files inclusions =============================================================== */
+
+#include "xpt2046.h"
+#include "ili9341.h"
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include "driver/spi_master.h"
+#include <assert.h>
+#endif
+
+/* === Macros definitions ====================================================================== */
+
+#define CMD_READ_X        0xD0 /*!< 12 bits differential conversion of the X position */
+#define CMD_READ_Y        0x90 /*!< 12 bits differential conversion of the Y position */
+#define CMD_READ_Z1       0xB0 /*!< 12 bits differential conversion of the Z1 pressure */
+
+#define BYTES_PER_READ    3 /*!< Command byte followed by two bytes with the 12 bits answer */
+#define READS_PER_SAMPLE  3 /*!< Z1, X and Y conversions of a sample */
+#define BATCH_SIZE        (XPT2046_SAMPLES * READS_PER_SAMPLE * BYTES_PER_READ)
+
+/* === Private data type declarations ========================================================== */
+
+/* === Private variable declarations =========================================================== */
+
+/* === Private function declarations =========================================================== */
+
+/**
+ * @brief  		Median of a set of samples
+ * @param[in]  	samples: Samples to combine, they are sorted in place
+ * @param[in]  	count: Number of samples
+ * @retval 		Median value
+ */
+static uint16_t Median(uint16_t * samples, uint8_t count);
+
+/**
+ * @brief  		Convert a raw reading to LCD pixels
+ * @param[in]  	raw: Raw 12 bits reading
+ * @param[in]  	min: Raw reading at the first pixel
+ * @param[in]  	max: Raw reading at the last pixel
+ * @param[in]  	size: Number of pixels of the axis
+ * @param[in]  	invert: The axis grows in the opposite direction of the LCD
+ * @retval 		Position in pixels, clipped to the LCD
+ */
+static uint16_t Scale(uint16_t raw, uint16_t min, uint16_t max, uint16_t size, bool invert);
+
+/* === Public variable definitions ============================================================= */
+
+/* === Private variable definitions ============================================================ */
+
+static xpt2046_transfer_t bus_transfer; /*!< Access to the controller, NULL until initialized */
+
+#ifdef ESP_PLATFORM
+static spi_device_handle_t spi;
+#endif
+
+/* === Private function definitions ============================================================ */
+
+#ifdef ESP_PLATFORM
+/* Exchange a batch with the controller through the SPI bus shared with the LCD. Uses
+ * spi_device_polling_transmit, the batch is short and fits in a single transaction.
+ */
+static void spi_transfer(const uint8_t * tx, uint8_t * rx, size_t length) {
+    esp_err_t ret;
+    spi_transaction_t t;
+    memset(&t, 0, sizeof(t));                   // Zero out the transaction
+    t.length = length * 8;                      // Len is in bytes, transaction length is in bits.
+    t.tx_buffer = tx;                           // Commands
+    t.rx_buffer = rx;                           // Answers
+    ret = spi_device_polling_transmit(spi, &t); // Transmit!
+    assert(ret == ESP_OK);                      // Should have had no issues.
+}
+#endif
+
+static uint16_t Median(uint16_t * samples, uint8_t count) {
+    uint16_t value;
+    uint8_t i, j;
+
+    /* Insertion sort, the batch is a handful of samples */
+    for (i = 1; i < count; i++) {
+        value = samples[i];
+        for (j = i; (j > 0) && (samples[j - 1] > value); j--) {
+            samples[j] = samples[j - 1];
+        }
+        samples[j] = value;
+    }
+    return samples[count / 2];
+}
+
+static uint16_t Scale(uint16_t raw, uint16_t min, uint16_t max, uint16_t size, bool invert) {
+    uint32_t position;
+
+    if (raw < min) {
+        raw = min;
+    }
+    if (raw > max) {
+        raw = max;
+    }
+    position = ((uint32_t)(raw - min) * (size - 1)) / (max - min);
+    return invert ? (size - 1) - position : position;
+}
+
+/* === Public function implementation ========================================================== */
+
+void XPT2046Init(xpt2046_transfer_t transfer) {
+#ifdef ESP_PLATFORM
+    if (transfer == NULL) {
+        esp_err_t ret;
+        spi_device_interface_config_t devcfg = {
+            .clock_speed_hz = XPT2046_CLOCK,    // The converter is much slower than the LCD
+            .mode = 0,                          // SPI mode 0
+            .spics_io_num = XPT2046_PIN_NUM_CS, // CS pin
+            .queue_size = 1,                    // A single batch at a time
+        };
+        // Attach the touch controller to the bus initialized by the LCD
+        ret = spi_bus_add_device(ILI9341_SPI_PORT, &devcfg, &spi);
+        ESP_ERROR_CHECK(ret);
+        transfer = spi_transfer;
+    }
+#endif
+    bus_transfer = transfer;
+}
+
+bool XPT2046Read(xpt2046_point_t * point) {
+    static uint8_t tx[BATCH_SIZE];
+    static uint8_t rx[BATCH_SIZE];
+    uint16_t x[XPT2046_SAMPLES], y[XPT2046_SAMPLES], z[XPT2046_SAMPLES];
+    uint16_t * answers[READS_PER_SAMPLE] = {z, x, y};
+    const uint8_t commands[READS_PER_SAMPLE] = {CMD_READ_Z1, CMD_READ_X, CMD_READ_Y};
+    uint8_t sample, read;
+    uint8_t * answer;
+
+    if (bus_transfer == NULL) {
+        return false;
+    }
+
+    /* All the samples are taken in a single exchange, so the bus is requested only once */
+    memset(tx, 0, sizeof(tx));
+    for (sample = 0; sample < XPT2046_SAMPLES; sample++) {
+        for (read = 0; read < READS_PER_SAMPLE; read++) {
+            tx[(sample * READS_PER_SAMPLE + read) * BYTES_PER_READ] = commands[read];
+        }
+    }
+    bus_transfer(tx, rx, sizeof(tx));
+
+    /* The 12 bits answer starts on the bit after the command byte */
+    for (sample = 0; sample < XPT2046_SAMPLES; sample++) {
+        for (read = 0; read < READS_PER_SAMPLE; read++) {
+            answer = &rx[(sample * READS_PER_SAMPLE + read) * BYTES_PER_READ];
+            answers[read][sample] = (((answer[1] << 8) | answer[2]) >> 3) & 0x0FFF;
+        }
+    }
+
+    point->z = Median(z, XPT2046_SAMPLES);
+    if (point->z < XPT2046_Z_THRESHOLD) {
+        return false;
+    }
+    point->x = Scale(Median(x, XPT2046_SAMPLES), XPT2046_RAW_X_MIN, XPT2046_RAW_X_MAX, ILI9341_WIDTH,
+                     XPT2046_INVERT_X);
+    point->y = Scale(Median(y, XPT2046_SAMPLES), XPT2046_RAW_Y_MIN, XPT2046_RAW_Y_MAX, ILI9341_HEIGHT,
+                     XPT2046_INVERT_Y);
+    return true;
+}
+
+/* === End of documentation ==================================================================== */
@@ -0,0 +1,105 @@
+/************************************************************************************************
+Copyright (c) 2025, Erica Vidal <ericavidal@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial
+portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES
+OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*************************************************************************************************/
+
+#ifndef XPT2046_H_
+#define XPT2046_H_
+
+/** @file xpt2046.h
+ ** @brief Declaraciones de la biblioteca para el controlador táctil XPT2046 que comparte el bus SPI con el ILI9341
+ **/
+
+/* === Headers files inclusions ================================================================ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* === Cabecera C++ ============================================================================ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* === Public macros definitions =============================================================== */
+
+/* Touch pin conections, the other lines are shared with the LCD */
+#define XPT2046_PIN_NUM_CS   4
+
+/* Touch settings */
+#define XPT2046_CLOCK        2000000 /*!< Frequency of sck, the converter needs 125 kHz per sample */
+#define XPT2046_SAMPLES      5       /*!< Samples read in each batch, combined with a median filter */
+#define XPT2046_Z_THRESHOLD  100     /*!< Minimum pressure to consider the panel touched */
+
+/* Calibration of the raw 12 bits readings against the LCD in portrait orientation */
+#define XPT2046_RAW_X_MIN    200
+#define XPT2046_RAW_X_MAX    3900
+#define XPT2046_RAW_Y_MIN    200
+#define XPT2046_RAW_Y_MAX    3900
+#define XPT2046_INVERT_X     0
+#define XPT2046_INVERT_Y     0
+
+/* === Public data type declarations =========================================================== */
+
+/**
+ * @brief  Point touched on the panel
+ */
+typedef struct {
+    uint16_t x; /*!< X position in LCD pixels */
+    uint16_t y; /*!< Y position in LCD pixels */
+    uint16_t z; /*!< Pressure, raw value of the Z1 measurement */
+} xpt2046_point_t;
+
+/**
+ * @brief  Full duplex exchange of a buffer with the controller
+ * @param[in]  	tx: Bytes to send, commands followed by zeros while the answer is clocked out
+ * @param[out]  rx: Bytes received, same length as tx
+ * @param[in]  	length: Number of bytes to exchange
+ * @note        This is the only access of the driver to the bus, a mock device can be plugged here to test the
+ *              driver on the host.
+ */
+typedef void (*xpt2046_transfer_t)(const uint8_t * tx, uint8_t * rx, size_t length);
+
+/* === Public variable declarations ============================================================ */
+
+/* === Public function declarations ============================================================ */
+
+/**
+ * @brief  		Initializes the touch controller
+ * @param[in]  	transfer: Function to exchange data with the controller, NULL to attach it to the SPI bus of the
+ *              LCD. In that case @ref ILI9341Init must be called before, because it initializes the bus.
+ * @retval 		None
+ */
+void XPT2046Init(xpt2046_transfer_t transfer);
+
+/**
+ * @brief  		Reads the touched point
+ * @param[out] 	point: Position and pressure of the touch, median of a batch of samples
+ * @retval 		true if the panel is touched, false if it is not or the driver was not initialized
+ */
+bool XPT2046Read(xpt2046_point_t * point);
+
+/* === End of documentation ==================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* XPT2046_H_ */
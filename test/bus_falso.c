@@ -0,0 +1,462 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+/** @file bus_falso.c
+ ** @brief Definiciones del bus SPI simulado en el host, con la memoria de imagen de un ILI9341
+ **
+ ** Las reglas de arbitraje son las del driver maestro de ESP-IDF: un dispositivo que toma el bus lo usa en forma
+ ** exclusiva hasta liberarlo, y las transacciones de los demás esperan. Sin el bus tomado cada transacción espera que
+ ** termine la anterior. Una transacción que deja la selección activa solo es valida con el bus tomado.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "bus_falso.h"
+#include "driver/spi_master.h"
+#include "ili9341.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* === Macros definitions ========================================================================================== */
+
+#define COMANDO_INVERSION_NO 0x20 //!< Comando que vuelve a mostrar los colores sin invertir
+#define COMANDO_INVERSION_SI 0x21 //!< Comando que muestra los colores invertidos
+#define COMANDO_COLUMNAS     0x2A //!< Comando que fija las columnas de la ventana
+#define COMANDO_FILAS        0x2B //!< Comando que fija las filas de la ventana
+#define COMANDO_ESCRIBIR     0x2C //!< Comando que empieza a escribir pixeles en la ventana
+#define COMANDO_LEER         0x2E //!< Comando que empieza a leer pixeles de la ventana
+
+#define MAXIMO_CONECTADOS 4 //!< Cantidad de dispositivos simulados que se pueden conectar al bus
+
+/* === Private data type declarations ============================================================================== */
+
+//! @brief Interpretación de los bytes de datos que recibe la pantalla
+typedef enum {
+    DATOS_IGNORADOS, //!< Parametros de comandos que no cambian la memoria de imagen
+    DATOS_COLUMNAS,  //!< Limites de las columnas de la ventana
+    DATOS_FILAS,     //!< Limites de las filas de la ventana
+    DATOS_ESCRITURA, //!< Pixeles de 16 bits que se escriben en la ventana
+    DATOS_LECTURA,   //!< Pixeles de 18 bits que se leen de la ventana, después de un byte de descarte
+} datos_t;
+
+//! @brief Dispositivo agregado al bus por un driver
+struct spi_device_t {
+    int reloj;               //!< Frecuencia del reloj en Hz
+    int cs;                  //!< Terminal de selección
+    transaction_cb_t previa; //!< Función que el driver llama antes de cada transacción
+};
+
+/* === Private variable declarations =============================================================================== */
+
+/* === Private function declarations =============================================================================== */
+
+/* === Public variable definitions ================================================================================= */
+
+/* === Private variable definitions ================================================================================ */
+
+//! @brief Estado del bus, protegido por el cerrojo porque las pruebas de arbitraje lo usan desde varios hilos
+static struct {
+    pthread_mutex_t cerrojo;
+    pthread_cond_t cambio;
+    bool iniciado;              //!< El bus fue iniciado con spi_bus_initialize
+    spi_device_handle_t tomado; //!< Dispositivo que tomó el bus, NULL si está libre
+    bool ocupado;               //!< Hay una transacción en curso
+    struct {
+        int cs;
+        bus_falso_dispositivo_t atender;
+    } conectados[MAXIMO_CONECTADOS]; //!< Dispositivos simulados distintos de la pantalla
+    bus_falso_estadisticas_t estadisticas;
+    char * registro;   //!< Eventos guardados, NULL si no se registran
+    size_t tamano;     //!< Cantidad de eventos que entran en el registro
+    size_t eventos;    //!< Cantidad de eventos guardados
+    uint32_t demora;   //!< Duración real de cada transacción en microsegundos
+} bus = {
+    .cerrojo = PTHREAD_MUTEX_INITIALIZER,
+    .cambio = PTHREAD_COND_INITIALIZER,
+};
+
+//! @brief Estado de la pantalla, solo lo modifica la transacción en curso
+static struct {
+    uint16_t memoria[BUS_FALSO_LADO][BUS_FALSO_LADO];
+    struct {
+        uint16_t x0, x1, y0, y1;
+    } ventana;
+    uint16_t x, y;      //!< Posición del próximo pixel en la ventana
+    datos_t datos;      //!< Interpretación de los próximos bytes de datos
+    uint8_t parametros; //!< Bytes recibidos de los limites de la ventana
+    uint8_t alto;       //!< Byte alto del pixel que se está escribiendo
+    uint8_t byte;       //!< Byte del pixel que se está transfiriendo
+    bool descarte;      //!< Falta enviar el byte de descarte de la lectura
+    bool invertida;
+} pantalla;
+
+/* === Private function definitions ================================================================================ */
+
+static void Registrar(char evento) {
+    if ((bus.registro != NULL) && (bus.eventos < bus.tamano)) {
+        bus.registro[bus.eventos++] = evento;
+    }
+}
+
+static bus_falso_dispositivo_t Conectado(int cs) {
+    for (int indice = 0; indice < MAXIMO_CONECTADOS; indice++) {
+        if ((bus.conectados[indice].atender != NULL) && (bus.conectados[indice].cs == cs)) {
+            return bus.conectados[indice].atender;
+        }
+    }
+    return NULL;
+}
+
+static void Avanzar(void) {
+    // Al terminar la ventana la pantalla vuelve a su primer pixel
+    if (++pantalla.x > pantalla.ventana.x1) {
+        pantalla.x = pantalla.ventana.x0;
+        if (++pantalla.y > pantalla.ventana.y1) {
+            pantalla.y = pantalla.ventana.y0;
+        }
+    }
+}
+
+static void Comando(uint8_t comando) {
+    pantalla.datos = DATOS_IGNORADOS;
+    switch (comando) {
+    case COMANDO_INVERSION_NO:
+    case COMANDO_INVERSION_SI:
+        pantalla.invertida = (comando == COMANDO_INVERSION_SI);
+        break;
+    case COMANDO_COLUMNAS:
+    case COMANDO_FILAS:
+        pantalla.datos = (comando == COMANDO_COLUMNAS) ? DATOS_COLUMNAS : DATOS_FILAS;
+        pantalla.parametros = 0;
+        break;
+    case COMANDO_ESCRIBIR:
+    case COMANDO_LEER:
+        pantalla.datos = (comando == COMANDO_ESCRIBIR) ? DATOS_ESCRITURA : DATOS_LECTURA;
+        pantalla.x = pantalla.ventana.x0;
+        pantalla.y = pantalla.ventana.y0;
+        pantalla.byte = 0;
+        pantalla.descarte = true;
+        break;
+    default:
+        break;
+    }
+}
+
+static void Escribir(uint8_t dato) {
+    static uint8_t limites[4];
+    uint16_t color;
+
+    switch (pantalla.datos) {
+    case DATOS_COLUMNAS:
+    case DATOS_FILAS:
+        limites[pantalla.parametros++] = dato;
+        if (pantalla.parametros == sizeof(limites)) {
+            if (pantalla.datos == DATOS_COLUMNAS) {
+                pantalla.ventana.x0 = (limites[0] << 8) | limites[1];
+                pantalla.ventana.x1 = (limites[2] << 8) | limites[3];
+            } else {
+                pantalla.ventana.y0 = (limites[0] << 8) | limites[1];
+                pantalla.ventana.y1 = (limites[2] << 8) | limites[3];
+            }
+            pantalla.datos = DATOS_IGNORADOS;
+        }
+        break;
+    case DATOS_ESCRITURA:
+        // Un pixel puede quedar repartido entre dos transacciones
+        if (pantalla.byte++ == 0) {
+            pantalla.alto = dato;
+            break;
+        }
+        color = (pantalla.alto << 8) | dato;
+        if ((pantalla.x < BUS_FALSO_LADO) && (pantalla.y < BUS_FALSO_LADO)) {
+            pantalla.memoria[pantalla.y][pantalla.x] = color;
+        }
+        pantalla.byte = 0;
+        Avanzar();
+        break;
+    case DATOS_LECTURA:
+        bus.estadisticas.errores++;
+        break;
+    default:
+        break;
+    }
+}
+
+static uint8_t Leer(void) {
+    uint16_t color = 0;
+    uint8_t dato;
+
+    if (pantalla.datos != DATOS_LECTURA) {
+        bus.estadisticas.errores++;
+        return 0;
+    }
+    if (pantalla.descarte) {
+        pantalla.descarte = false;
+        return 0;
+    }
+    if ((pantalla.x < BUS_FALSO_LADO) && (pantalla.y < BUS_FALSO_LADO)) {
+        color = pantalla.memoria[pantalla.y][pantalla.x];
+    }
+    // Cada componente se devuelve con 6 bits alineados a la izquierda, el rojo y el azul con el bit bajo en cero
+    switch (pantalla.byte) {
+    case 0:
+        dato = (color >> 8) & 0xF8;
+        break;
+    case 1:
+        dato = (color >> 3) & 0xFC;
+        break;
+    default:
+        dato = (color << 3) & 0xF8;
+        break;
+    }
+    if (++pantalla.byte == 3) {
+        pantalla.byte = 0;
+        Avanzar();
+    }
+    return dato;
+}
+
+static void Pantalla(spi_transaction_t * t) {
+    const uint8_t * tx = (t->flags & SPI_TRANS_USE_TXDATA) ? t->tx_data : t->tx_buffer;
+    uint8_t * rx = (t->flags & SPI_TRANS_USE_RXDATA) ? t->rx_data : t->rx_buffer;
+    size_t cantidad = t->length / 8;
+
+    // La linea D/C es la que fija la función previa del driver a partir del campo user
+    if ((intptr_t)t->user == 0) {
+        if ((tx == NULL) || (cantidad != 1)) {
+            bus.estadisticas.errores++;
+            return;
+        }
+        Comando(tx[0]);
+    } else {
+        for (size_t indice = 0; indice < cantidad; indice++) {
+            if (tx != NULL) {
+                Escribir(tx[indice]);
+            }
+            if (rx != NULL) {
+                rx[indice] = Leer();
+            }
+        }
+    }
+    // La lectura de la memoria termina cuando se desactiva la selección
+    if (!(t->flags & SPI_TRANS_CS_KEEP_ACTIVE) && (pantalla.datos == DATOS_LECTURA)) {
+        pantalla.datos = DATOS_IGNORADOS;
+    }
+}
+
+static void Otro(spi_device_handle_t dispositivo, spi_transaction_t * t) {
+    const uint8_t * tx = (t->flags & SPI_TRANS_USE_TXDATA) ? t->tx_data : t->tx_buffer;
+    uint8_t * rx = (t->flags & SPI_TRANS_USE_RXDATA) ? t->rx_data : t->rx_buffer;
+    bus_falso_dispositivo_t atender = Conectado(dispositivo->cs);
+    size_t cantidad = t->length / 8;
+
+    if (rx == NULL) {
+        return;
+    }
+    if ((atender == NULL) || (tx == NULL)) {
+        memset(rx, 0, cantidad);
+        return;
+    }
+    atender(tx, rx, cantidad);
+}
+
+/* === Public function implementation ============================================================================== */
+
+esp_err_t spi_bus_initialize(spi_host_device_t host_id, const spi_bus_config_t * bus_config, int dma_chan) {
+    esp_err_t resultado = ESP_OK;
+
+    pthread_mutex_lock(&bus.cerrojo);
+    if (bus.iniciado) {
+        resultado = ESP_ERR_INVALID_STATE;
+    }
+    bus.iniciado = true;
+    pthread_mutex_unlock(&bus.cerrojo);
+    return resultado;
+}
+
+esp_err_t spi_bus_add_device(spi_host_device_t host_id, const spi_device_interface_config_t * dev_config,
+                             spi_device_handle_t * handle) {
+    spi_device_handle_t dispositivo;
+
+    if (!bus.iniciado) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    dispositivo = malloc(sizeof(*dispositivo));
+    if (dispositivo == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    dispositivo->reloj = dev_config->clock_speed_hz;
+    dispositivo->cs = dev_config->spics_io_num;
+    dispositivo->previa = dev_config->pre_cb;
+
+    pthread_mutex_lock(&bus.cerrojo);
+    bus.estadisticas.conexiones++;
+    pthread_mutex_unlock(&bus.cerrojo);
+    *handle = dispositivo;
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_remove_device(spi_device_handle_t handle) {
+    esp_err_t resultado = ESP_OK;
+
+    pthread_mutex_lock(&bus.cerrojo);
+    if (bus.tomado == handle) {
+        bus.estadisticas.errores++;
+        resultado = ESP_ERR_INVALID_STATE;
+    }
+    pthread_mutex_unlock(&bus.cerrojo);
+    if (resultado == ESP_OK) {
+        free(handle);
+    }
+    return resultado;
+}
+
+esp_err_t spi_device_acquire_bus(spi_device_handle_t device, uint32_t wait) {
+    pthread_mutex_lock(&bus.cerrojo);
+    if (bus.tomado == device) {
+        bus.estadisticas.errores++;
+        pthread_mutex_unlock(&bus.cerrojo);
+        return ESP_ERR_INVALID_STATE;
+    }
+    while ((bus.tomado != NULL) || bus.ocupado) {
+        pthread_cond_wait(&bus.cambio, &bus.cerrojo);
+    }
+    bus.tomado = device;
+    Registrar(EVENTO_TOMA);
+    pthread_mutex_unlock(&bus.cerrojo);
+    return ESP_OK;
+}
+
+void spi_device_release_bus(spi_device_handle_t dev) {
+    pthread_mutex_lock(&bus.cerrojo);
+    if (bus.tomado != dev) {
+        bus.estadisticas.errores++;
+    } else {
+        bus.tomado = NULL;
+        Registrar(EVENTO_LIBERA);
+        pthread_cond_broadcast(&bus.cambio);
+    }
+    pthread_mutex_unlock(&bus.cerrojo);
+}
+
+esp_err_t spi_device_polling_transmit(spi_device_handle_t handle, spi_transaction_t * trans_desc) {
+    bool es_pantalla = (handle->cs == ILI9341_PIN_NUM_CS);
+
+    pthread_mutex_lock(&bus.cerrojo);
+    if ((trans_desc->flags & SPI_TRANS_CS_KEEP_ACTIVE) && (bus.tomado != handle)) {
+        bus.estadisticas.errores++;
+        pthread_mutex_unlock(&bus.cerrojo);
+        return ESP_ERR_INVALID_ARG;
+    }
+    while (bus.ocupado || ((bus.tomado != NULL) && (bus.tomado != handle))) {
+        pthread_cond_wait(&bus.cambio, &bus.cerrojo);
+    }
+    bus.ocupado = true;
+    Registrar(es_pantalla ? EVENTO_PANTALLA : EVENTO_OTRO);
+    bus.estadisticas.transacciones++;
+    bus.estadisticas.bits += trans_desc->length;
+    bus.estadisticas.tiempo_ns += (uint64_t)trans_desc->length * 1000000000u / handle->reloj;
+    pthread_mutex_unlock(&bus.cerrojo);
+
+    if (bus.demora > 0) {
+        usleep(bus.demora);
+    }
+    if (handle->previa != NULL) {
+        handle->previa(trans_desc);
+    }
+    if (es_pantalla) {
+        Pantalla(trans_desc);
+    } else {
+        Otro(handle, trans_desc);
+    }
+
+    pthread_mutex_lock(&bus.cerrojo);
+    bus.ocupado = false;
+    pthread_cond_broadcast(&bus.cambio);
+    pthread_mutex_unlock(&bus.cerrojo);
+    return ESP_OK;
+}
+
+void BusFalsoConectar(int cs, bus_falso_dispositivo_t atender) {
+    pthread_mutex_lock(&bus.cerrojo);
+    for (int indice = 0; indice < MAXIMO_CONECTADOS; indice++) {
+        if ((bus.conectados[indice].atender == NULL) || (bus.conectados[indice].cs == cs)) {
+            bus.conectados[indice].cs = cs;
+            bus.conectados[indice].atender = atender;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&bus.cerrojo);
+}
+
+void BusFalsoLlenar(uint16_t color) {
+    for (int y = 0; y < BUS_FALSO_LADO; y++) {
+        for (int x = 0; x < BUS_FALSO_LADO; x++) {
+            pantalla.memoria[y][x] = color;
+        }
+    }
+}
+
+uint16_t BusFalsoPixel(uint16_t x, uint16_t y) {
+    if ((x >= BUS_FALSO_LADO) || (y >= BUS_FALSO_LADO)) {
+        return 0;
+    }
+    return pantalla.memoria[y][x];
+}
+
+bool BusFalsoInvertida(void) {
+    return pantalla.invertida;
+}
+
+void BusFalsoLeerEstadisticas(bus_falso_estadisticas_t * estadisticas) {
+    pthread_mutex_lock(&bus.cerrojo);
+    *estadisticas = bus.estadisticas;
+    pthread_mutex_unlock(&bus.cerrojo);
+}
+
+void BusFalsoBorrarEstadisticas(void) {
+    pthread_mutex_lock(&bus.cerrojo);
+    memset(&bus.estadisticas, 0, sizeof(bus.estadisticas));
+    pthread_mutex_unlock(&bus.cerrojo);
+}
+
+void BusFalsoRegistrar(char * registro, size_t tamano) {
+    pthread_mutex_lock(&bus.cerrojo);
+    bus.registro = registro;
+    bus.tamano = tamano;
+    bus.eventos = 0;
+    pthread_mutex_unlock(&bus.cerrojo);
+}
+
+size_t BusFalsoEventos(void) {
+    size_t eventos;
+
+    pthread_mutex_lock(&bus.cerrojo);
+    eventos = bus.eventos;
+    pthread_mutex_unlock(&bus.cerrojo);
+    return eventos;
+}
+
+void BusFalsoDemorar(uint32_t microsegundos) {
+    bus.demora = microsegundos;
+}
+
+/* === End of documentation ======================================================================================== */
@@ -0,0 +1,163 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+#ifndef BUS_FALSO_H_
+#define BUS_FALSO_H_
+
+/** @file bus_falso.h
+ ** @brief Declaraciones del bus SPI simulado en el host, con la memoria de imagen de un ILI9341
+ **
+ ** El bus reemplaza al driver maestro SPI de ESP-IDF, así las bibliotecas se prueban con el mismo driver de pantalla
+ ** que usa el firmware. La pantalla conectada en el terminal ILI9341_PIN_NUM_CS interpreta los comandos de ventana,
+ ** escritura y lectura de la memoria de imagen y de inversión. Los demás dispositivos se atienden con las funciones
+ ** que se conectan con @ref BusFalsoConectar.
+ **
+ ** La memoria se direcciona en coordenadas de la orientación que use la pantalla, sin aplicar MADCTL, y es cuadrada
+ ** para que entren las cuatro orientaciones. Los pixeles fuera de la memoria se descartan.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* === Cabecera C++ ================================================================================================ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* === Public macros definitions =================================================================================== */
+
+//! @brief Lado en pixeles de la memoria de imagen simulada
+#define BUS_FALSO_LADO 320
+
+//! @brief Evento del registro: un dispositivo tomó el bus con spi_device_acquire_bus
+#define EVENTO_TOMA 'A'
+
+//! @brief Evento del registro: un dispositivo liberó el bus con spi_device_release_bus
+#define EVENTO_LIBERA 'R'
+
+//! @brief Evento del registro: transacción de la pantalla
+#define EVENTO_PANTALLA 'P'
+
+//! @brief Evento del registro: transacción de otro dispositivo
+#define EVENTO_OTRO 'T'
+
+/* === Public data type declarations =============================================================================== */
+
+//! @brief Tráfico del bus desde el último borrado
+typedef struct {
+    uint32_t transacciones; //!< Transacciones de todos los dispositivos
+    uint64_t bits;          //!< Bits intercambiados
+    uint64_t tiempo_ns;     //!< Tiempo de reloj de esos bits a la frecuencia de cada dispositivo
+    uint32_t conexiones;    //!< Dispositivos agregados al bus, el driver de pantalla lo hace para cambiar el reloj
+    uint32_t errores;       //!< Transacciones que el driver original rechaza o que la pantalla no puede interpretar
+} bus_falso_estadisticas_t;
+
+/**
+ * @brief Intercambio full duplex de un dispositivo simulado
+ *
+ * @param  tx        Bytes enviados por el maestro
+ * @param  rx        Bytes que devuelve el dispositivo, la misma cantidad que los enviados
+ * @param  cantidad  Cantidad de bytes intercambiados
+ */
+typedef void (*bus_falso_dispositivo_t)(const uint8_t * tx, uint8_t * rx, size_t cantidad);
+
+/* === Public variable declarations ================================================================================ */
+
+/* === Public function declarations ================================================================================ */
+
+/**
+ * @brief Función para atender con un dispositivo simulado las transacciones de una selección
+ *
+ * @param  cs        Terminal de selección con el que el driver agrega el dispositivo al bus
+ * @param  atender   Función que responde las transacciones del dispositivo
+ */
+void BusFalsoConectar(int cs, bus_falso_dispositivo_t atender);
+
+/**
+ * @brief Función para llenar la memoria de imagen sin generar tráfico en el bus
+ *
+ * @param  color     Color de todos los pixeles
+ */
+void BusFalsoLlenar(uint16_t color);
+
+/**
+ * @brief Función para leer un pixel de la memoria de imagen
+ *
+ * @param  x         Columna del pixel
+ * @param  y         Fila del pixel
+ * @return uint16_t  Color del pixel en RGB565
+ */
+uint16_t BusFalsoPixel(uint16_t x, uint16_t y);
+
+/**
+ * @brief Función para consultar si la pantalla muestra los colores invertidos
+ *
+ * @return bool      true después de DISPLAY_INV_ON, false después de DISPLAY_INV_OFF
+ */
+bool BusFalsoInvertida(void);
+
+/**
+ * @brief Función para copiar el tráfico del bus desde el último borrado
+ *
+ * @param  estadisticas  Donde se copia el tráfico
+ */
+void BusFalsoLeerEstadisticas(bus_falso_estadisticas_t * estadisticas);
+
+/**
+ * @brief Función para poner en cero el tráfico del bus
+ */
+void BusFalsoBorrarEstadisticas(void);
+
+/**
+ * @brief Función para guardar la secuencia de eventos del bus
+ *
+ * Cada evento se guarda como uno de los caracteres EVENTO_*, los que no entran en el registro se descartan.
+ *
+ * @param  registro  Memoria para los eventos, NULL para dejar de guardarlos
+ * @param  tamano    Cantidad de eventos que entran en el registro
+ */
+void BusFalsoRegistrar(char * registro, size_t tamano);
+
+/**
+ * @brief Función para consultar la cantidad de eventos guardados desde que se empezó a registrar
+ *
+ * @return size_t    Cantidad de eventos, sin contar los descartados
+ */
+size_t BusFalsoEventos(void);
+
+/**
+ * @brief Función para que cada transacción ocupe el bus durante un tiempo real
+ *
+ * Sirve para que las tareas de una prueba concurrente se intercalen sobre el bus.
+ *
+ * @param  microsegundos Tiempo que dura cada transacción, cero para que no demore
+ */
+void BusFalsoDemorar(uint32_t microsegundos);
+
+/* === End of documentation ======================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BUS_FALSO_H_ */
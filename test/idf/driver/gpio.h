@@ -0,0 +1,58 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+#ifndef DRIVER_GPIO_H_
+#define DRIVER_GPIO_H_
+
+/** @file gpio.h
+ ** @brief Reemplazo en el host del driver de terminales de ESP-IDF, los niveles escritos se descartan
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/* === Public data type declarations =============================================================================== */
+
+typedef int gpio_num_t;
+
+typedef enum {
+    GPIO_MODE_DISABLE = 0,
+    GPIO_MODE_INPUT = 1,
+    GPIO_MODE_OUTPUT = 2,
+} gpio_mode_t;
+
+typedef struct {
+    uint64_t pin_bit_mask;
+    gpio_mode_t mode;
+    bool pull_up_en;
+    bool pull_down_en;
+    int intr_type;
+} gpio_config_t;
+
+/* === Public function declarations ================================================================================ */
+
+esp_err_t gpio_config(const gpio_config_t * config);
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level);
+
+/* === End of documentation ======================================================================================== */
+
+#endif /* DRIVER_GPIO_H_ */
@@ -0,0 +1,109 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+#ifndef DRIVER_SPI_MASTER_H_
+#define DRIVER_SPI_MASTER_H_
+
+/** @file spi_master.h
+ ** @brief Reemplazo en el host del driver maestro SPI de ESP-IDF
+ **
+ ** Declara solo la parte del driver que usan las bibliotecas de la pantalla y del táctil. Las transacciones las
+ ** atiende el bus simulado de bus_falso.c, con las mismas reglas de arbitraje que el driver original.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stddef.h>
+
+/* === Public macros definitions =================================================================================== */
+
+#define SPI_DMA_CH_AUTO          3        //!< Canal de DMA elegido por el driver
+#define SPI_TRANS_USE_RXDATA     (1 << 2) //!< Los datos recibidos se guardan en rx_data en lugar de rx_buffer
+#define SPI_TRANS_USE_TXDATA     (1 << 3) //!< Los datos a enviar se toman de tx_data en lugar de tx_buffer
+#define SPI_TRANS_CS_KEEP_ACTIVE (1 << 8) //!< La selección queda activa al terminar, requiere tener el bus tomado
+
+/* === Public data type declarations =============================================================================== */
+
+typedef enum {
+    SPI1_HOST = 0,
+    SPI2_HOST = 1,
+    SPI3_HOST = 2,
+} spi_host_device_t;
+
+typedef struct spi_device_t * spi_device_handle_t;
+
+typedef struct spi_transaction_t spi_transaction_t;
+
+typedef void (*transaction_cb_t)(spi_transaction_t * trans);
+
+struct spi_transaction_t {
+    uint32_t flags;
+    uint16_t cmd;
+    uint64_t addr;
+    size_t length;
+    size_t rxlength;
+    void * user;
+    union {
+        const void * tx_buffer;
+        uint8_t tx_data[4];
+    };
+    union {
+        void * rx_buffer;
+        uint8_t rx_data[4];
+    };
+};
+
+typedef struct {
+    int mosi_io_num;
+    int miso_io_num;
+    int sclk_io_num;
+    int quadwp_io_num;
+    int quadhd_io_num;
+    int max_transfer_sz;
+    uint32_t flags;
+} spi_bus_config_t;
+
+typedef struct {
+    uint8_t command_bits;
+    uint8_t address_bits;
+    uint8_t dummy_bits;
+    uint8_t mode;
+    int clock_speed_hz;
+    int spics_io_num;
+    uint32_t flags;
+    int queue_size;
+    transaction_cb_t pre_cb;
+    transaction_cb_t post_cb;
+} spi_device_interface_config_t;
+
+/* === Public function declarations ================================================================================ */
+
+esp_err_t spi_bus_initialize(spi_host_device_t host_id, const spi_bus_config_t * bus_config, int dma_chan);
+esp_err_t spi_bus_add_device(spi_host_device_t host_id, const spi_device_interface_config_t * dev_config,
+                             spi_device_handle_t * handle);
+esp_err_t spi_bus_remove_device(spi_device_handle_t handle);
+esp_err_t spi_device_polling_transmit(spi_device_handle_t handle, spi_transaction_t * trans_desc);
+esp_err_t spi_device_acquire_bus(spi_device_handle_t device, uint32_t wait);
+void spi_device_release_bus(spi_device_handle_t dev);
+
+/* === End of documentation ======================================================================================== */
+
+#endif /* DRIVER_SPI_MASTER_H_ */
@@ -0,0 +1,58 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+#ifndef ESP_ERR_H_
+#define ESP_ERR_H_
+
+/** @file esp_err.h
+ ** @brief Reemplazo en el host de los códigos de error de ESP-IDF que usan los drivers
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* === Public macros definitions =================================================================================== */
+
+#define ESP_OK                0      //!< Operación exitosa
+#define ESP_FAIL              -1     //!< Error generico
+#define ESP_ERR_INVALID_ARG   0x102  //!< Argumento invalido
+#define ESP_ERR_INVALID_STATE 0x103  //!< Operación invalida en el estado actual
+#define ESP_ERR_INVALID_SIZE  0x104  //!< Tamaño invalido
+#define ESP_ERR_NOT_FOUND     0x105  //!< El recurso pedido no existe
+#define ESP_ERR_NVS_NOT_FOUND 0x1102 //!< La clave no existe en la memoria no volatil
+
+//! @brief Termina el programa si la expresión no devuelve @ref ESP_OK, como en el firmware
+#define ESP_ERROR_CHECK(x)                                                                                             \
+    do {                                                                                                               \
+        esp_err_t error_ = (x);                                                                                        \
+        if (error_ != ESP_OK) {                                                                                        \
+            fprintf(stderr, "%s:%d: error 0x%x en %s\n", __FILE__, __LINE__, error_, #x);                              \
+            abort();                                                                                                   \
+        }                                                                                                              \
+    } while (0)
+
+/* === Public data type declarations =============================================================================== */
+
+typedef int esp_err_t;
+
+/* === End of documentation ======================================================================================== */
+
+#endif /* ESP_ERR_H_ */
@@ -0,0 +1,42 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+#ifndef ESP_LOG_H_
+#define ESP_LOG_H_
+
+/** @file esp_log.h
+ ** @brief Reemplazo en el host de los mensajes de registro de ESP-IDF
+ **
+ ** Los avisos y errores se muestran en la salida de errores, los mensajes informativos se descartan para que la
+ ** salida de las pruebas solo tenga sus resultados.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include <stdio.h>
+
+/* === Public macros definitions =================================================================================== */
+
+#define ESP_LOGI(tag, formato, ...) ((void)(tag))
+#define ESP_LOGW(tag, formato, ...) fprintf(stderr, "W %s: " formato "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGE(tag, formato, ...) fprintf(stderr, "E %s: " formato "\n", tag, ##__VA_ARGS__)
+
+/* === End of documentation ======================================================================================== */
+
+#endif /* ESP_LOG_H_ */
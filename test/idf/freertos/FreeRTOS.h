@@ -0,0 +1,67 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+#ifndef FREERTOS_H_
+#define FREERTOS_H_
+
+/** @file FreeRTOS.h
+ ** @brief Reemplazo en el host de los tipos y la configuración de FreeRTOS
+ **
+ ** Como en ESP-IDF, incluir este archivo declara también las colas y los grupos de eventos. Las pruebas no crean
+ ** tareas, las funciones de plataforma_falsa.c no hacen nada o devuelven valores fijos.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* === Public macros definitions =================================================================================== */
+
+#define pdFALSE            0
+#define pdTRUE             1
+#define pdFAIL             0
+#define pdPASS             1
+#define portMAX_DELAY      0xFFFFFFFFU
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms)  ((TickType_t)(ms) / portTICK_PERIOD_MS)
+#define tskIDLE_PRIORITY   0
+
+/* === Public data type declarations =============================================================================== */
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t EventBits_t;
+
+typedef struct tskTaskControlBlock * TaskHandle_t;
+typedef struct QueueDefinition * QueueHandle_t;
+typedef struct EventGroupDef_t * EventGroupHandle_t;
+typedef struct tmrTimerControl * TimerHandle_t;
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "freertos/queue.h"
+#include "freertos/event_groups.h"
+
+/* === End of documentation ======================================================================================== */
+
+#endif /* FREERTOS_H_ */
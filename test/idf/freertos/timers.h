@@ -0,0 +1,45 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+#ifndef FREERTOS_TIMERS_H_
+#define FREERTOS_TIMERS_H_
+
+/** @file timers.h
+ ** @brief Reemplazo en el host de los temporizadores de software de FreeRTOS
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "freertos/FreeRTOS.h"
+
+/* === Public data type declarations =============================================================================== */
+
+typedef void (*TimerCallbackFunction_t)(TimerHandle_t timer);
+
+/* === Public function declarations ================================================================================ */
+
+TimerHandle_t xTimerCreate(const char * name, const TickType_t period, const BaseType_t auto_reload, void * id,
+                           TimerCallbackFunction_t callback);
+BaseType_t xTimerIsTimerActive(TimerHandle_t timer);
+BaseType_t xTimerReset(TimerHandle_t timer, TickType_t ticks_to_wait);
+BaseType_t xTimerStop(TimerHandle_t timer, TickType_t ticks_to_wait);
+
+/* === End of documentation ======================================================================================== */
+
+#endif /* FREERTOS_TIMERS_H_ */
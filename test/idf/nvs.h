@@ -0,0 +1,55 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+#ifndef NVS_H_
+#define NVS_H_
+
+/** @file nvs.h
+ ** @brief Reemplazo en el host de la memoria no volatil de ESP-IDF
+ **
+ ** El host no tiene memoria no volatil, abrir un espacio de nombres siempre falla y la calibración del reloj SPI de la
+ ** pantalla se repite en cada ejecución.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "esp_err.h"
+#include <stdint.h>
+
+/* === Public macros definitions =================================================================================== */
+
+#define NVS_READONLY  0
+#define NVS_READWRITE 1
+
+/* === Public data type declarations =============================================================================== */
+
+typedef uint32_t nvs_handle_t;
+typedef int nvs_open_mode_t;
+
+/* === Public function declarations ================================================================================ */
+
+esp_err_t nvs_open(const char * name, nvs_open_mode_t open_mode, nvs_handle_t * out_handle);
+esp_err_t nvs_get_u32(nvs_handle_t handle, const char * key, uint32_t * out_value);
+esp_err_t nvs_set_u32(nvs_handle_t handle, const char * key, uint32_t value);
+esp_err_t nvs_commit(nvs_handle_t handle);
+void nvs_close(nvs_handle_t handle);
+
+/* === End of documentation ======================================================================================== */
+
+#endif /* NVS_H_ */
@@ -0,0 +1,129 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+/** @file plataforma_falsa.c
+ ** @brief Funciones de ESP-IDF y FreeRTOS que usan las bibliotecas, reemplazadas en el host
+ **
+ ** Las pruebas llaman directamente a las funciones que dibujan, sin tareas ni colas. Estas funciones solo permiten
+ ** enlazar los módulos del firmware: no hacen nada o devuelven valores fijos.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "driver/gpio.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/timers.h"
+#include "nvs.h"
+#include <time.h>
+
+/* === Public function implementation ============================================================================== */
+
+esp_err_t gpio_config(const gpio_config_t * config) {
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level) {
+    return ESP_OK;
+}
+
+esp_err_t nvs_open(const char * name, nvs_open_mode_t open_mode, nvs_handle_t * out_handle) {
+    return ESP_ERR_NVS_NOT_FOUND;
+}
+
+esp_err_t nvs_get_u32(nvs_handle_t handle, const char * key, uint32_t * out_value) {
+    return ESP_ERR_NVS_NOT_FOUND;
+}
+
+esp_err_t nvs_set_u32(nvs_handle_t handle, const char * key, uint32_t value) {
+    return ESP_ERR_NVS_NOT_FOUND;
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle) {
+    return ESP_ERR_NVS_NOT_FOUND;
+}
+
+void nvs_close(nvs_handle_t handle) {
+}
+
+int64_t esp_timer_get_time(void) {
+    struct timespec ahora;
+
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    return (int64_t)ahora.tv_sec * 1000000 + ahora.tv_nsec / 1000;
+}
+
+void vTaskDelay(const TickType_t ticks) {
+}
+
+TickType_t xTaskGetTickCount(void) {
+    return (TickType_t)(esp_timer_get_time() / 1000 / portTICK_PERIOD_MS);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    return NULL;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait) {
+    return 0;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void * buffer, TickType_t ticks_to_wait) {
+    return pdFAIL;
+}
+
+BaseType_t xQueueOverwrite(QueueHandle_t queue, const void * item) {
+    return pdPASS;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group) {
+    return 0;
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, const EventBits_t bits) {
+    return bits;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, const EventBits_t bits) {
+    return 0;
+}
+
+TimerHandle_t xTimerCreate(const char * name, const TickType_t period, const BaseType_t auto_reload, void * id,
+                           TimerCallbackFunction_t callback) {
+    return NULL;
+}
+
+BaseType_t xTimerIsTimerActive(TimerHandle_t timer) {
+    return pdFALSE;
+}
+
+BaseType_t xTimerReset(TimerHandle_t timer, TickType_t ticks_to_wait) {
+    return pdPASS;
+}
+
+BaseType_t xTimerStop(TimerHandle_t timer, TickType_t ticks_to_wait) {
+    return pdPASS;
+}
+
+/* === End of documentation ======================================================================================== */
@@ -0,0 +1,66 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+#ifndef PRUEBA_H_
+#define PRUEBA_H_
+
+/** @file prueba.h
+ ** @brief Verificaciones comunes de las pruebas en el host
+ **
+ ** Cada programa de prueba cuenta sus fallas con @ref VERIFICAR y termina con @ref RESULTADO, que devuelve un valor
+ ** distinto de cero a ctest si alguna verificación falló.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include <stdio.h>
+
+/* === Public macros definitions =================================================================================== */
+
+//! @brief Cantidad de fallas que se muestran, las siguientes solo se cuentan
+#define FALLAS_MOSTRADAS 20
+
+/**
+ * @brief Verifica una condición y muestra el mensaje si no se cumple
+ *
+ * @param  condicion Expresión que debe ser verdadera
+ * @param  ...       Formato y argumentos del mensaje, como en printf
+ */
+#define VERIFICAR(condicion, ...)                                                                                      \
+    do {                                                                                                               \
+        if (!(condicion)) {                                                                                            \
+            if (fallas++ < FALLAS_MOSTRADAS) {                                                                         \
+                printf("%s:%d: ", __FILE__, __LINE__);                                                                 \
+                printf(__VA_ARGS__);                                                                                   \
+                printf("\n");                                                                                          \
+            }                                                                                                          \
+        }                                                                                                              \
+    } while (0)
+
+//! @brief Muestra la cantidad de fallas y devuelve el código de salida del programa de prueba
+#define RESULTADO() (printf("%d fallas\n", fallas), (fallas != 0))
+
+/* === Public variable declarations ================================================================================ */
+
+//! @brief Fallas del programa de prueba, cada programa la define una vez
+extern int fallas;
+
+/* === End of documentation ======================================================================================== */
+
+#endif /* PRUEBA_H_ */
@@ -0,0 +1,119 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+
+/** @file tactil_falso.c
+ ** @brief Controlador táctil XPT2046 simulado para las pruebas en el host
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "tactil_falso.h"
+#include <string.h>
+
+/* === Macros definitions ========================================================================================== */
+
+#define COMANDO_X  0xD0 //!< Conversión diferencial de 12 bits de la posición X
+#define COMANDO_Y  0x90 //!< Conversión diferencial de 12 bits de la posición Y
+#define COMANDO_Z1 0xB0 //!< Conversión diferencial de 12 bits de la presión Z1
+
+#define BYTES_RESPUESTA 2 //!< Bytes que siguen al comando con el bit de ocupado y los 12 bits de la conversión
+
+/* === Private data type declarations ============================================================================== */
+
+//! @brief Canal de conversión del controlador
+typedef struct {
+    uint8_t comando;                    //!< Comando que convierte el canal
+    uint16_t muestras[XPT2046_SAMPLES]; //!< Conversiones que devuelve en cada lote
+} canal_t;
+
+/* === Private variable declarations =============================================================================== */
+
+/* === Private function declarations =============================================================================== */
+
+/* === Public variable definitions ================================================================================= */
+
+/* === Private variable definitions ================================================================================ */
+
+static canal_t canales[] = {{COMANDO_Z1}, {COMANDO_X}, {COMANDO_Y}};
+
+static uint32_t lotes;   //!< Intercambios con el controlador
+static uint32_t errores; //!< Intercambios que el controlador no pudo interpretar
+
+/* === Private function definitions ================================================================================ */
+
+static canal_t * Canal(uint8_t comando) {
+    for (int indice = 0; indice < sizeof(canales) / sizeof(canales[0]); indice++) {
+        if (canales[indice].comando == comando) {
+            return &canales[indice];
+        }
+    }
+    return NULL;
+}
+
+/* === Public function implementation ============================================================================== */
+
+void TactilFalsoTocar(const uint16_t * z, const uint16_t * x, const uint16_t * y) {
+    memcpy(Canal(COMANDO_Z1)->muestras, z, sizeof(canales[0].muestras));
+    memcpy(Canal(COMANDO_X)->muestras, x, sizeof(canales[0].muestras));
+    memcpy(Canal(COMANDO_Y)->muestras, y, sizeof(canales[0].muestras));
+}
+
+void TactilFalsoTransferir(const uint8_t * tx, uint8_t * rx, size_t cantidad) {
+    uint8_t convertidas[sizeof(canales) / sizeof(canales[0])] = {0};
+    bool correcto = true;
+    uint16_t respuesta;
+    canal_t * canal;
+    size_t indice = 0;
+
+    memset(rx, 0, cantidad);
+    while (indice < cantidad) {
+        canal = Canal(tx[indice]);
+        if (canal == NULL) {
+            // Fuera de las conversiones el controlador solo recibe ceros
+            correcto = correcto && (tx[indice] == 0);
+            indice++;
+        } else if ((indice + BYTES_RESPUESTA >= cantidad) || (convertidas[canal - canales] == XPT2046_SAMPLES)) {
+            correcto = false;
+            indice++;
+        } else {
+            // El primer bit después del comando es el de ocupado, siempre en cero, y le siguen los 12 bits
+            respuesta = (canal->muestras[convertidas[canal - canales]++] & 0x0FFF) << 3;
+            rx[indice + 1] = respuesta >> 8;
+            rx[indice + 2] = respuesta & 0xFF;
+            correcto = correcto && (tx[indice + 1] == 0) && (tx[indice + 2] == 0);
+            indice += 1 + BYTES_RESPUESTA;
+        }
+    }
+
+    lotes++;
+    if (!correcto) {
+        errores++;
+    }
+}
+
+uint32_t TactilFalsoLotes(void) {
+    return lotes;
+}
+
+uint32_t TactilFalsoErrores(void) {
+    return errores;
+}
+
+/* === End of documentation ======================================================================================== */
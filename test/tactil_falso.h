@@ -0,0 +1,93 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+
+#ifndef TACTIL_FALSO_H_
+#define TACTIL_FALSO_H_
+
+/** @file tactil_falso.h
+ ** @brief Controlador táctil XPT2046 simulado para las pruebas en el host
+ **
+ ** Responde las conversiones de Z1, X e Y de cada lote con las muestras cargadas por la prueba, codificadas como las
+ ** devuelve el controlador: el bit de ocupado y los 12 bits de la conversión en los dos bytes que siguen al comando.
+ ** La función de intercambio se puede pasar a XPT2046Init o conectar al bus simulado con BusFalsoConectar.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "xpt2046.h"
+#include <stdint.h>
+#include <stddef.h>
+
+/* === Cabecera C++ ================================================================================================ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* === Public macros definitions =================================================================================== */
+
+/* === Public data type declarations =============================================================================== */
+
+/* === Public variable declarations ================================================================================ */
+
+/* === Public function declarations ================================================================================ */
+
+/**
+ * @brief Función para cargar las muestras que devuelven los lotes siguientes
+ *
+ * @param  z   Conversiones de la presión Z1, XPT2046_SAMPLES valores de 12 bits
+ * @param  x   Conversiones de la posición X
+ * @param  y   Conversiones de la posición Y
+ */
+void TactilFalsoTocar(const uint16_t * z, const uint16_t * x, const uint16_t * y);
+
+/**
+ * @brief Función de intercambio full duplex con el controlador simulado
+ *
+ * Cada comando de conversión recibe la muestra siguiente de su canal en los dos bytes que lo siguen. Un comando
+ * desconocido, un byte de relleno distinto de cero o más muestras que las cargadas cuentan como un error.
+ *
+ * @param  tx        Bytes enviados al controlador
+ * @param  rx        Bytes devueltos, la misma cantidad que los enviados
+ * @param  cantidad  Cantidad de bytes intercambiados
+ */
+void TactilFalsoTransferir(const uint8_t * tx, uint8_t * rx, size_t cantidad);
+
+/**
+ * @brief Función para consultar la cantidad de intercambios con el controlador
+ *
+ * @return uint32_t  Intercambios desde el inicio de la prueba
+ */
+uint32_t TactilFalsoLotes(void);
+
+/**
+ * @brief Función para consultar la cantidad de intercambios que el controlador no pudo interpretar
+ *
+ * @return uint32_t  Intercambios con errores desde el inicio de la prueba
+ */
+uint32_t TactilFalsoErrores(void);
+
+/* === End of documentation ======================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TACTIL_FALSO_H_ */
@@ -0,0 +1,171 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+
+/** @file test_arbitraje.c
+ ** @brief Prueba de que el táctil no interrumpe los lotes de dibujo de la pantalla
+ **
+ ** El driver del táctil se compila con ESP_PLATFORM y se agrega al bus simulado como segundo dispositivo, igual que en
+ ** el firmware. Un hilo lee el táctil cada vez que la pantalla abre un lote, así cada lectura se pide con el bus
+ ** tomado. En el registro del bus ninguna transacción del táctil puede quedar entre la toma y la liberación de un lote,
+ ** ni entre los fragmentos de una lectura de la memoria de imagen.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "bus_falso.h"
+#include "tactil_falso.h"
+#include "prueba.h"
+#include "ili9341.h"
+#include <pthread.h>
+
+/* === Macros definitions ========================================================================================== */
+
+#define LOTES         40    //!< Lotes de dibujo, el táctil se lee una vez en cada uno
+#define DEMORA        20    //!< Duración en microsegundos de cada transacción del bus
+#define EVENTOS       65536  //!< Eventos del bus que entran en el registro
+#define LADO_LECTURA  24    //!< Lado del cuadrado que se lee de la memoria de imagen en cada lote
+
+/* === Private data type declarations ============================================================================== */
+
+/* === Private variable declarations =============================================================================== */
+
+/* === Private function declarations =============================================================================== */
+
+/* === Public variable definitions ================================================================================= */
+
+int fallas;
+
+/* === Private variable definitions ================================================================================ */
+
+static pthread_mutex_t cerrojo = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cambio = PTHREAD_COND_INITIALIZER;
+
+static int lotes_abiertos;        //!< Lotes que abrió la pantalla, cada uno habilita una lectura del táctil
+static bool lote_abierto;         //!< La pantalla tiene el bus tomado
+static int lecturas_en_lote;      //!< Lecturas del táctil pedidas mientras la pantalla tenía el bus tomado
+static int lecturas_tocadas;      //!< Lecturas del táctil que informaron el toque cargado
+static char registro[EVENTOS];    //!< Eventos del bus durante la prueba
+static uint16_t leidos[LADO_LECTURA * LADO_LECTURA];
+
+/* === Private function definitions ================================================================================ */
+
+static void * LeerTactil(void * argumentos) {
+    xpt2046_point_t punto;
+    bool pedida_en_lote;
+
+    for (int lectura = 0; lectura < LOTES; lectura++) {
+        pthread_mutex_lock(&cerrojo);
+        while (lotes_abiertos <= lectura) {
+            pthread_cond_wait(&cambio, &cerrojo);
+        }
+        pedida_en_lote = lote_abierto;
+        pthread_mutex_unlock(&cerrojo);
+
+        if (XPT2046Read(&punto)) {
+            lecturas_tocadas++;
+        }
+        lecturas_en_lote += pedida_en_lote;
+    }
+    return NULL;
+}
+
+static void AbrirLote(bool abierto) {
+    pthread_mutex_lock(&cerrojo);
+    lote_abierto = abierto;
+    lotes_abiertos += abierto;
+    pthread_cond_broadcast(&cambio);
+    pthread_mutex_unlock(&cerrojo);
+}
+
+// Dibuja los lotes como la tarea de la pantalla, con dibujos sueltos y lecturas de la memoria entre ellos
+static void Dibujar(void) {
+    for (int lote = 0; lote < LOTES; lote++) {
+        ILI9341StartBatch();
+        AbrirLote(true);
+        for (int rectangulo = 0; rectangulo < 8; rectangulo++) {
+            ILI9341DrawFilledRectangle(10 * rectangulo, lote, 10 * rectangulo + 40, lote + 20,
+                                       (lote & 1) ? ILI9341_RED : ILI9341_BLUE);
+        }
+        AbrirLote(false);
+        ILI9341EndBatch();
+
+        ILI9341DrawFilledRectangle(0, 200, 20, 220, ILI9341_GREEN);
+        ILI9341ReadRect(0, 0, LADO_LECTURA - 1, LADO_LECTURA - 1, leidos);
+    }
+}
+
+// Cuenta las transacciones del táctil y las que quedaron dentro de un lote de la pantalla
+static void RevisarRegistro(void) {
+    size_t eventos = BusFalsoEventos();
+    int tactil = 0, intercaladas = 0;
+    bool tomado = false;
+
+    VERIFICAR(eventos < EVENTOS, "el registro de %d eventos se llenó", EVENTOS);
+    for (size_t indice = 0; indice < eventos && indice < EVENTOS; indice++) {
+        switch (registro[indice]) {
+        case EVENTO_TOMA:
+            tomado = true;
+            break;
+        case EVENTO_LIBERA:
+            tomado = false;
+            break;
+        case EVENTO_OTRO:
+            tactil++;
+            intercaladas += tomado;
+            break;
+        default:
+            break;
+        }
+    }
+    VERIFICAR(tactil == LOTES, "el táctil hizo %d transacciones en %d lecturas", tactil, LOTES);
+    VERIFICAR(intercaladas == 0, "%d transacciones del táctil quedaron dentro de un lote de la pantalla", intercaladas);
+}
+
+/* === Public function implementation ============================================================================== */
+
+int main(void) {
+    const uint16_t z[] = {400, 400, 400, 400, 400};
+    const uint16_t x[] = {2000, 2000, 2000, 2000, 2000};
+    const uint16_t y[] = {2000, 2000, 2000, 2000, 2000};
+    bus_falso_estadisticas_t bus;
+    pthread_t tactil;
+
+    ILI9341Init();
+    XPT2046Init(NULL);
+    BusFalsoConectar(XPT2046_PIN_NUM_CS, TactilFalsoTransferir);
+    TactilFalsoTocar(z, x, y);
+
+    BusFalsoDemorar(DEMORA);
+    BusFalsoRegistrar(registro, sizeof(registro));
+    pthread_create(&tactil, NULL, LeerTactil, NULL);
+    Dibujar();
+    pthread_join(tactil, NULL);
+    RevisarRegistro();
+    BusFalsoRegistrar(NULL, 0);
+
+    VERIFICAR(lecturas_tocadas == LOTES, "%d de %d lecturas informaron el toque", lecturas_tocadas, LOTES);
+    VERIFICAR(lecturas_en_lote > 0, "ninguna lectura se pidió con el bus tomado, la prueba no ejercitó el arbitraje");
+    VERIFICAR(TactilFalsoErrores() == 0, "el controlador no pudo interpretar %u intercambios", TactilFalsoErrores());
+    BusFalsoLeerEstadisticas(&bus);
+    VERIFICAR(bus.errores == 0, "el bus rechazó %u transacciones", bus.errores);
+    return RESULTADO();
+}
+
+/* === End of documentation ======================================================================================== */
@@ -0,0 +1,605 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+/** @file test_digitos.c
+ ** @brief Prueba de los paneles de digitos contra imagenes de referencia y presupuestos de tráfico
+ **
+ ** Cada caracter de cada tamaño de display.h se dibuja con el driver ILI9341 del firmware sobre el bus simulado, y la
+ ** celda se compara pixel por pixel con la imagen del tamaño en referencias/. Un caracter tiene que quedar igual
+ ** dibujado sobre la celda apagada de un panel nuevo, dibujado completo después de BorrarDigito, después de cualquier
+ ** otro caracter y después de cambiar dos veces el color del panel, con la cache de caracteres pre-dibujados y sin
+ ** ella. Las ventanas y los bytes de cada llamada a DibujarDigito no pueden superar los de referencias/presupuestos.txt.
+ **
+ ** Con --actualizar las imagenes y los presupuestos se vuelven a generar con el código actual. Con --registrar las
+ ** geometrias se registran antes de crear los paneles, como en el firmware, en lugar de calcularse al crearlos.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "bus_falso.h"
+#include "prueba.h"
+#include "display.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* === Macros definitions ========================================================================================== */
+
+#define COLOR_VACIO 0x1234 //!< Color de la memoria antes de cada dibujo, no lo usa ningún panel
+#define COLOR_OTRO  ILI9341_RED //!< Color al que se cambian los segmentos encendidos antes de restaurarlos
+
+#define ORIGEN_X 8 //!< Columna de la esquina de los paneles, deja un borde para ver si se pinta fuera de la celda
+#define ORIGEN_Y 8 //!< Fila de la esquina de los paneles
+
+#define GRIS_FONDO     0   //!< Nivel de gris de la referencia para el color de fondo
+#define GRIS_VACIO     64  //!< Nivel de gris de la referencia para los pixeles que el panel no pinta
+#define GRIS_APAGADO   128 //!< Nivel de gris de la referencia para los segmentos apagados
+#define GRIS_ENCENDIDO 255 //!< Nivel de gris de la referencia para los segmentos encendidos
+
+#define COLUMNAS_TEXTO      8  //!< Caracteres por fila en las referencias de los paneles de texto
+#define MAXIMO_PRESUPUESTOS 32 //!< Cantidad de presupuestos del archivo de referencia
+#define LARGO_CLAVE         48 //!< Largo máximo del nombre de un presupuesto
+
+#define ARCHIVO_PRESUPUESTOS REFERENCIAS "/presupuestos.txt" //!< Ventanas y bytes permitidos a cada dibujo
+
+/* === Private data type declarations ============================================================================== */
+
+//! @brief Tamaño de caracter usado en display.h
+typedef struct {
+    const char * nombre;   //!< Nombre del tamaño, de su imagen de referencia y de sus presupuestos
+    geometria_t geometria; //!< Geometria con la que display.h declara el tamaño
+    bool texto;            //!< Los paneles de este tamaño son de texto
+} tamano_t;
+
+//! @brief Imagen con un nivel de gris por pixel, que guarda las celdas de todos los caracteres de un tamaño
+typedef struct {
+    uint8_t * pixeles;
+    uint16_t ancho;
+    uint16_t alto;
+} hoja_t;
+
+//! @brief Ventanas y bytes permitidos a un dibujo
+typedef struct {
+    char clave[LARGO_CLAVE];
+    uint32_t ventanas;
+    uint32_t bytes;
+} presupuesto_t;
+
+/* === Private variable declarations =============================================================================== */
+
+static const tamano_t TAMANOS[] = {
+    {"digito", GEOMETRIA_DIGITO, false},   {"digito_a", GEOMETRIA_DIGITO_A, false},
+    {"digito_p", GEOMETRIA_DIGITO_P, false}, {"texto_p", GEOMETRIA_TEXTO_P, true},
+    {"texto_e", GEOMETRIA_TEXTO_E, true},
+};
+
+//! @brief Separadores de los paneles de digitos, con la columna que les da display.h
+static const struct {
+    const char * formato;
+    uint16_t separacion;
+} SEPARADORES[] = {
+    {"8.", SEPARACION_PUNTO},
+    {"8:", SEPARACION_DOS_PUNTOS},
+};
+
+/* === Private function declarations =============================================================================== */
+
+/* === Public variable definitions ================================================================================= */
+
+int fallas;
+
+/* === Private variable definitions ================================================================================ */
+
+static bool actualizar; //!< Las referencias se generan en lugar de compararse
+
+static presupuesto_t presupuestos[MAXIMO_PRESUPUESTOS]; //!< Presupuestos leídos, o medidos al actualizar
+static int cantidad_presupuestos;
+
+/* === Private function definitions ================================================================================ */
+
+static int Gris(uint16_t color) {
+    switch (color) {
+    case DIGITO_FONDO:
+        return GRIS_FONDO;
+    case DIGITO_APAGADO:
+        return GRIS_APAGADO;
+    case DIGITO_ENCENDIDO:
+        return GRIS_ENCENDIDO;
+    case COLOR_VACIO:
+        return GRIS_VACIO;
+    default:
+        return -1;
+    }
+}
+
+static int CantidadCaracteres(const tamano_t * tamano) {
+    return tamano->texto ? 64 : 17;
+}
+
+static uint8_t Caracter(const tamano_t * tamano, int indice) {
+    return tamano->texto ? ' ' + indice : indice;
+}
+
+static void Nombre(const tamano_t * tamano, int indice, char * nombre) {
+    if (tamano->texto) {
+        sprintf(nombre, "'%c'", Caracter(tamano, indice));
+    } else {
+        sprintf(nombre, "%d", indice);
+    }
+}
+
+static uint16_t AnchoCelda(const tamano_t * tamano) {
+    return tamano->geometria.ancho + 1;
+}
+
+static uint16_t AltoCelda(const tamano_t * tamano) {
+    return tamano->geometria.alto + 1;
+}
+
+// Los digitos ocupan la primera fila y los separadores la segunda, los caracteres de texto van en filas de a ocho
+static void UbicarCaracter(const tamano_t * tamano, int indice, uint16_t * x, uint16_t * y) {
+    int columnas = tamano->texto ? COLUMNAS_TEXTO : CantidadCaracteres(tamano);
+
+    *x = (indice % columnas) * AnchoCelda(tamano);
+    *y = (indice / columnas) * AltoCelda(tamano);
+}
+
+static void UbicarSeparador(const tamano_t * tamano, int indice, uint16_t * x, uint16_t * y) {
+    *x = 0;
+    for (int anterior = 0; anterior < indice; anterior++) {
+        *x += AnchoCelda(tamano) + SEPARADORES[anterior].separacion;
+    }
+    *y = AltoCelda(tamano);
+}
+
+static void MedidasHoja(const tamano_t * tamano, uint16_t * ancho, uint16_t * alto) {
+    uint16_t x, y;
+
+    if (tamano->texto) {
+        *ancho = COLUMNAS_TEXTO * AnchoCelda(tamano);
+        *alto = ((CantidadCaracteres(tamano) + COLUMNAS_TEXTO - 1) / COLUMNAS_TEXTO) * AltoCelda(tamano);
+    } else {
+        UbicarSeparador(tamano, sizeof(SEPARADORES) / sizeof(SEPARADORES[0]), &x, &y);
+        *ancho = CantidadCaracteres(tamano) * AnchoCelda(tamano);
+        *ancho = (x > *ancho) ? x : *ancho;
+        *alto = 2 * AltoCelda(tamano);
+    }
+}
+
+static void NombreArchivo(const tamano_t * tamano, char * archivo, size_t largo) {
+    snprintf(archivo, largo, "%s/%s.pgm", REFERENCIAS, tamano->nombre);
+}
+
+static bool LeerHoja(const tamano_t * tamano, hoja_t * hoja) {
+    char archivo[256];
+    unsigned ancho, alto, maximo;
+    bool leida = false;
+    FILE * entrada;
+
+    NombreArchivo(tamano, archivo, sizeof(archivo));
+    entrada = fopen(archivo, "rb");
+    if (entrada == NULL) {
+        VERIFICAR(false, "%s: no se puede abrir, se genera con --actualizar", archivo);
+        return false;
+    }
+    if ((fscanf(entrada, "P5 %u %u %u", &ancho, &alto, &maximo) == 3) && (fgetc(entrada) != EOF) &&
+        (ancho == hoja->ancho) && (alto == hoja->alto) && (maximo == 255)) {
+        leida = (fread(hoja->pixeles, 1, ancho * alto, entrada) == ancho * alto);
+    }
+    fclose(entrada);
+    VERIFICAR(leida, "%s: no es una imagen de %ux%u, se genera con --actualizar", archivo, hoja->ancho, hoja->alto);
+    return leida;
+}
+
+static void GuardarHoja(const tamano_t * tamano, const hoja_t * hoja) {
+    char archivo[256];
+    FILE * salida;
+
+    NombreArchivo(tamano, archivo, sizeof(archivo));
+    salida = fopen(archivo, "wb");
+    if (salida == NULL) {
+        VERIFICAR(false, "%s: no se puede crear", archivo);
+        return;
+    }
+    fprintf(salida, "P5\n%u %u\n255\n", hoja->ancho, hoja->alto);
+    fwrite(hoja->pixeles, 1, hoja->ancho * hoja->alto, salida);
+    fclose(salida);
+}
+
+// Las celdas de los caracteres se pintan completas, las columnas de los separadores solo en los puntos
+static void CapturarCelda(hoja_t * hoja, uint16_t x, uint16_t y, uint16_t ancho, uint16_t alto, uint16_t pintadas) {
+    uint16_t color;
+
+    for (uint16_t fila = 0; fila < alto; fila++) {
+        for (uint16_t columna = 0; columna < ancho; columna++) {
+            color = BusFalsoPixel(ORIGEN_X + columna, ORIGEN_Y + fila);
+            VERIFICAR(Gris(color) >= 0, "el pixel %u,%u es %04X, que no es un color del panel", columna, fila, color);
+            VERIFICAR((color != COLOR_VACIO) || (columna >= pintadas), "el pixel %u,%u de la celda quedó sin pintar",
+                      columna, fila);
+            hoja->pixeles[(y + fila) * hoja->ancho + x + columna] = (Gris(color) >= 0) ? Gris(color) : GRIS_VACIO;
+        }
+    }
+}
+
+// Compara la celda con la referencia y verifica que no se pintó nada en el borde que la rodea
+static bool CompararCelda(const hoja_t * hoja, uint16_t x, uint16_t y, uint16_t ancho, uint16_t alto,
+                          const char * descripcion) {
+    int esperado, obtenido;
+
+    for (int fila = -1; fila <= alto; fila++) {
+        for (int columna = -1; columna <= ancho; columna++) {
+            obtenido = Gris(BusFalsoPixel(ORIGEN_X + columna, ORIGEN_Y + fila));
+            if ((fila < 0) || (fila == alto) || (columna < 0) || (columna == ancho)) {
+                esperado = GRIS_VACIO;
+            } else {
+                esperado = hoja->pixeles[(y + fila) * hoja->ancho + x + columna];
+            }
+            if (obtenido != esperado) {
+                VERIFICAR(false, "%s: el pixel %d,%d es %04X y se esperaba el gris %d", descripcion, columna, fila,
+                          BusFalsoPixel(ORIGEN_X + columna, ORIGEN_Y + fila), esperado);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static panel_t NuevoPanel(const tamano_t * tamano, bool cache) {
+    panel_t panel;
+
+    BusFalsoLlenar(COLOR_VACIO);
+    if (tamano->texto) {
+        panel = CrearPanelTexto(ORIGEN_X, ORIGEN_Y, 1, tamano->geometria.alto, tamano->geometria.ancho,
+                                DIGITO_ENCENDIDO, DIGITO_APAGADO, DIGITO_FONDO);
+    } else {
+        panel = CrearPanel(ORIGEN_X, ORIGEN_Y, 1, tamano->geometria.alto, tamano->geometria.ancho, DIGITO_ENCENDIDO,
+                           DIGITO_APAGADO, DIGITO_FONDO);
+    }
+    VERIFICAR(panel != PANEL_INVALIDO, "%s: no se pudo crear el panel", tamano->nombre);
+    if (cache) {
+        VERIFICAR(UsarCacheDigitos(panel), "%s: no hay memoria para la cache", tamano->nombre);
+    }
+    return panel;
+}
+
+static void Medir(panel_t panel, uint8_t caracter, ili9341_stats_t * maximo, ili9341_stats_t * total) {
+    ili9341_stats_t medido;
+
+    ILI9341ResetStats();
+    DibujarDigito(panel, 0, caracter);
+    ILI9341GetStats(&medido);
+    if (maximo->windows < medido.windows) {
+        maximo->windows = medido.windows;
+    }
+    if (maximo->bytes < medido.bytes) {
+        maximo->bytes = medido.bytes;
+    }
+    if (total) {
+        total->windows += medido.windows;
+        total->bytes += medido.bytes;
+    }
+}
+
+static void Presupuesto(const char * tamano, const char * camino, const char * dibujo, const ili9341_stats_t * medido) {
+    char clave[LARGO_CLAVE];
+    presupuesto_t * presupuesto = NULL;
+
+    snprintf(clave, sizeof(clave), "%s.%s.%s", tamano, camino, dibujo);
+    printf("%-32s %6u ventanas %9u bytes\n", clave, medido->windows, medido->bytes);
+    if (actualizar) {
+        if (cantidad_presupuestos < MAXIMO_PRESUPUESTOS) {
+            presupuesto = &presupuestos[cantidad_presupuestos++];
+            strcpy(presupuesto->clave, clave);
+            presupuesto->ventanas = medido->windows;
+            presupuesto->bytes = medido->bytes;
+        }
+        return;
+    }
+
+    for (int indice = 0; indice < cantidad_presupuestos; indice++) {
+        if (strcmp(presupuestos[indice].clave, clave) == 0) {
+            presupuesto = &presupuestos[indice];
+        }
+    }
+    VERIFICAR(presupuesto != NULL, "%s: no tiene presupuesto, se genera con --actualizar", clave);
+    if (presupuesto) {
+        VERIFICAR(medido->windows <= presupuesto->ventanas, "%s: %u ventanas, el presupuesto es de %u", clave,
+                  medido->windows, presupuesto->ventanas);
+        VERIFICAR(medido->bytes <= presupuesto->bytes, "%s: %u bytes, el presupuesto es de %u", clave, medido->bytes,
+                  presupuesto->bytes);
+    }
+}
+
+static void LeerPresupuestos(void) {
+    char linea[128];
+    FILE * entrada = fopen(ARCHIVO_PRESUPUESTOS, "r");
+
+    if (entrada == NULL) {
+        VERIFICAR(false, "%s: no se puede abrir, se genera con --actualizar", ARCHIVO_PRESUPUESTOS);
+        return;
+    }
+    while (fgets(linea, sizeof(linea), entrada) && (cantidad_presupuestos < MAXIMO_PRESUPUESTOS)) {
+        presupuesto_t * presupuesto = &presupuestos[cantidad_presupuestos];
+
+        if ((linea[0] != '#') &&
+            (sscanf(linea, "%47s %u %u", presupuesto->clave, &presupuesto->ventanas, &presupuesto->bytes) == 3)) {
+            cantidad_presupuestos++;
+        }
+    }
+    fclose(entrada);
+}
+
+static void GuardarPresupuestos(void) {
+    FILE * salida = fopen(ARCHIVO_PRESUPUESTOS, "w");
+
+    if (salida == NULL) {
+        VERIFICAR(false, "%s: no se puede crear", ARCHIVO_PRESUPUESTOS);
+        return;
+    }
+    fprintf(salida, "# Ventanas y bytes que envía a la pantalla una llamada a DibujarDigito, generado con\n");
+    fprintf(salida, "# test_digitos --actualizar. completo es el peor caracter dibujado después de BorrarDigito,\n");
+    fprintf(salida, "# cambio el peor paso de un caracter a otro y todos la suma de los pasos entre todos los pares.\n");
+    fprintf(salida, "# clave ventanas bytes\n");
+    for (int indice = 0; indice < cantidad_presupuestos; indice++) {
+        fprintf(salida, "%s %u %u\n", presupuestos[indice].clave, presupuestos[indice].ventanas,
+                presupuestos[indice].bytes);
+    }
+    fclose(salida);
+}
+
+static void GenerarHoja(const tamano_t * tamano, hoja_t * hoja) {
+    uint16_t x, y;
+    panel_t panel;
+
+    for (int indice = 0; indice < CantidadCaracteres(tamano); indice++) {
+        panel = NuevoPanel(tamano, false);
+        DibujarDigito(panel, 0, Caracter(tamano, indice));
+        UbicarCaracter(tamano, indice, &x, &y);
+        CapturarCelda(hoja, x, y, AnchoCelda(tamano), AltoCelda(tamano), AnchoCelda(tamano));
+        LiberarPanel(panel);
+    }
+    for (int indice = 0; !tamano->texto && (indice < sizeof(SEPARADORES) / sizeof(SEPARADORES[0])); indice++) {
+        BusFalsoLlenar(COLOR_VACIO);
+        panel = CrearPanelFormato(ORIGEN_X, ORIGEN_Y, SEPARADORES[indice].formato, SEPARADORES[indice].separacion,
+                                  tamano->geometria.alto, tamano->geometria.ancho, DIGITO_ENCENDIDO, DIGITO_APAGADO,
+                                  DIGITO_FONDO, NULL);
+        DibujarDigito(panel, 0, 8);
+        UbicarSeparador(tamano, indice, &x, &y);
+        CapturarCelda(hoja, x, y, AnchoCelda(tamano) + SEPARADORES[indice].separacion, AltoCelda(tamano),
+                      AnchoCelda(tamano));
+        LiberarPanel(panel);
+    }
+}
+
+static void ProbarCaracteres(const tamano_t * tamano, const hoja_t * hoja, bool cache) {
+    const char * camino = cache ? "cache" : "segmentos";
+    ili9341_stats_t completo = {0}, cambio = {0}, todos = {0};
+    char desde_nombre[8], hasta_nombre[8], descripcion[96];
+    uint16_t x, y;
+    panel_t panel;
+
+    for (int desde = 0; desde < CantidadCaracteres(tamano); desde++) {
+        Nombre(tamano, desde, desde_nombre);
+        UbicarCaracter(tamano, desde, &x, &y);
+        panel = NuevoPanel(tamano, cache);
+
+        DibujarDigito(panel, 0, Caracter(tamano, desde));
+        snprintf(descripcion, sizeof(descripcion), "%s con %s: %s sobre la celda apagada", tamano->nombre, camino,
+                 desde_nombre);
+        CompararCelda(hoja, x, y, AnchoCelda(tamano), AltoCelda(tamano), descripcion);
+
+        BorrarDigito(panel, 0);
+        Medir(panel, Caracter(tamano, desde), &completo, NULL);
+        snprintf(descripcion, sizeof(descripcion), "%s con %s: %s completo", tamano->nombre, camino, desde_nombre);
+        CompararCelda(hoja, x, y, AnchoCelda(tamano), AltoCelda(tamano), descripcion);
+
+        for (int hasta = 0; hasta < CantidadCaracteres(tamano); hasta++) {
+            Nombre(tamano, hasta, hasta_nombre);
+            UbicarCaracter(tamano, hasta, &x, &y);
+            DibujarDigito(panel, 0, Caracter(tamano, desde));
+            Medir(panel, Caracter(tamano, hasta), &cambio, &todos);
+            snprintf(descripcion, sizeof(descripcion), "%s con %s: %s después de %s", tamano->nombre, camino,
+                     hasta_nombre, desde_nombre);
+            CompararCelda(hoja, x, y, AnchoCelda(tamano), AltoCelda(tamano), descripcion);
+        }
+
+        UbicarCaracter(tamano, desde, &x, &y);
+        DibujarDigito(panel, 0, Caracter(tamano, desde));
+        ChangeColor(panel, COLOR_OTRO, true);
+        ChangeColor(panel, DIGITO_ENCENDIDO, true);
+        snprintf(descripcion, sizeof(descripcion), "%s con %s: %s después de cambiar el color", tamano->nombre, camino,
+                 desde_nombre);
+        CompararCelda(hoja, x, y, AnchoCelda(tamano), AltoCelda(tamano), descripcion);
+        LiberarPanel(panel);
+    }
+
+    Presupuesto(tamano->nombre, camino, "completo", &completo);
+    Presupuesto(tamano->nombre, camino, "cambio", &cambio);
+    Presupuesto(tamano->nombre, camino, "todos", &todos);
+}
+
+static void ProbarSeparadores(const tamano_t * tamano, const hoja_t * hoja, bool cache) {
+    char descripcion[96];
+    uint16_t x, y;
+    panel_t panel;
+
+    for (int indice = 0; indice < sizeof(SEPARADORES) / sizeof(SEPARADORES[0]); indice++) {
+        BusFalsoLlenar(COLOR_VACIO);
+        panel = CrearPanelFormato(ORIGEN_X, ORIGEN_Y, SEPARADORES[indice].formato, SEPARADORES[indice].separacion,
+                                  tamano->geometria.alto, tamano->geometria.ancho, DIGITO_ENCENDIDO, DIGITO_APAGADO,
+                                  DIGITO_FONDO, NULL);
+        if (cache) {
+            UsarCacheDigitos(panel);
+        }
+        UbicarSeparador(tamano, indice, &x, &y);
+
+        DibujarDigito(panel, 0, 8);
+        snprintf(descripcion, sizeof(descripcion), "%s con %s: separador \"%s\"", tamano->nombre,
+                 cache ? "cache" : "segmentos", SEPARADORES[indice].formato);
+        CompararCelda(hoja, x, y, AnchoCelda(tamano) + SEPARADORES[indice].separacion, AltoCelda(tamano),
+                      descripcion);
+
+        ChangeColor(panel, COLOR_OTRO, true);
+        ChangeColor(panel, DIGITO_ENCENDIDO, true);
+        snprintf(descripcion, sizeof(descripcion), "%s con %s: separador \"%s\" después de cambiar el color",
+                 tamano->nombre, cache ? "cache" : "segmentos", SEPARADORES[indice].formato);
+        CompararCelda(hoja, x, y, AnchoCelda(tamano) + SEPARADORES[indice].separacion, AltoCelda(tamano),
+                      descripcion);
+        LiberarPanel(panel);
+    }
+}
+
+// Apaga y enciende el primer separador de un panel con dos: solo se pintan los cuadrados de ese separador
+static void ProbarParpadeo(const tamano_t * tamano, bool cache) {
+    static uint16_t antes[BUS_FALSO_LADO][BUS_FALSO_LADO];
+    uint16_t desde = ORIGEN_X + tamano->geometria.ancho, hasta;
+    int cambiados, ajenos, cuadrados;
+    ili9341_stats_t medido; // Cada ventana suma 8 bytes de parámetros de CASET y PASET
+    char formato[8];
+    panel_t panel;
+
+    for (size_t indice = 0; indice < sizeof(SEPARADORES) / sizeof(SEPARADORES[0]); indice++) {
+        snprintf(formato, sizeof(formato), "8%c8%c8", SEPARADORES[indice].formato[1], SEPARADORES[indice].formato[1]);
+        hasta = desde + SEPARADORES[indice].separacion;
+        cuadrados = (SEPARADORES[indice].formato[1] == ':') ? 2 : 1;
+        BusFalsoLlenar(COLOR_VACIO);
+        panel = CrearPanelFormato(ORIGEN_X, ORIGEN_Y, formato, SEPARADORES[indice].separacion, tamano->geometria.alto,
+                                  tamano->geometria.ancho, DIGITO_ENCENDIDO, DIGITO_APAGADO, DIGITO_FONDO, NULL);
+        if (cache) {
+            UsarCacheDigitos(panel);
+        }
+        DibujarNumero(panel, 888, NUMERO_CEROS);
+        for (int y = 0; y < BUS_FALSO_LADO; y++) {
+            for (int x = 0; x < BUS_FALSO_LADO; x++) {
+                antes[y][x] = BusFalsoPixel(x, y);
+            }
+        }
+
+        ILI9341ResetStats();
+        DibujarSeparador(panel, 0, false);
+        ILI9341GetStats(&medido);
+        cambiados = 0;
+        ajenos = 0;
+        for (int y = 0; y < BUS_FALSO_LADO; y++) {
+            for (int x = 0; x < BUS_FALSO_LADO; x++) {
+                if (BusFalsoPixel(x, y) != antes[y][x]) {
+                    cambiados++;
+                    ajenos += (x < desde) || (x > hasta) || (antes[y][x] != DIGITO_ENCENDIDO) ||
+                              (BusFalsoPixel(x, y) != DIGITO_APAGADO);
+                }
+            }
+        }
+        VERIFICAR(medido.windows == cuadrados, "%s: apagar \"%s\" abrió %u ventanas y tiene %d cuadrados",
+                  tamano->nombre, SEPARADORES[indice].formato, medido.windows, cuadrados);
+        VERIFICAR((cambiados > 0) && (2 * cambiados + 8 * cuadrados == medido.bytes) && (ajenos == 0),
+                  "%s: apagar \"%s\" envió %u bytes y cambió %d pixeles, %d fuera de sus cuadrados", tamano->nombre,
+                  SEPARADORES[indice].formato, medido.bytes, cambiados, ajenos);
+
+        // Apagado se mantiene al redibujar el digito y al cambiar el color del panel
+        BorrarDigito(panel, 0);
+        DibujarDigito(panel, 0, 8);
+        ChangeColor(panel, COLOR_OTRO, true);
+        ChangeColor(panel, DIGITO_ENCENDIDO, true);
+        ajenos = 0;
+        for (int y = 0; y < BUS_FALSO_LADO; y++) {
+            for (int x = desde; x <= hasta; x++) {
+                ajenos += (antes[y][x] == DIGITO_ENCENDIDO) && (BusFalsoPixel(x, y) != DIGITO_APAGADO);
+            }
+        }
+        VERIFICAR(ajenos == 0, "%s: \"%s\" apagado se volvió a encender en %d pixeles", tamano->nombre,
+                  SEPARADORES[indice].formato, ajenos);
+
+        ILI9341ResetStats();
+        DibujarSeparador(panel, 0, true);
+        ILI9341GetStats(&medido);
+        VERIFICAR(medido.windows == cuadrados, "%s: encender \"%s\" abrió %u ventanas", tamano->nombre,
+                  SEPARADORES[indice].formato, medido.windows);
+        cambiados = 0;
+        for (int y = 0; y < BUS_FALSO_LADO; y++) {
+            for (int x = 0; x < BUS_FALSO_LADO; x++) {
+                cambiados += (BusFalsoPixel(x, y) != antes[y][x]);
+            }
+        }
+        VERIFICAR(cambiados == 0, "%s: después de encender \"%s\" quedan %d pixeles distintos", tamano->nombre,
+                  SEPARADORES[indice].formato, cambiados);
+        LiberarPanel(panel);
+    }
+}
+
+static void ProbarTamano(const tamano_t * tamano) {
+    hoja_t hoja;
+
+    MedidasHoja(tamano, &hoja.ancho, &hoja.alto);
+    hoja.pixeles = calloc(hoja.ancho, hoja.alto);
+    if (actualizar) {
+        GenerarHoja(tamano, &hoja);
+    } else if (!LeerHoja(tamano, &hoja)) {
+        free(hoja.pixeles);
+        return;
+    }
+
+    ProbarCaracteres(tamano, &hoja, false);
+    if (!tamano->texto) {
+        ProbarCaracteres(tamano, &hoja, true);
+        ProbarSeparadores(tamano, &hoja, false);
+        ProbarSeparadores(tamano, &hoja, true);
+        ProbarParpadeo(tamano, false);
+        ProbarParpadeo(tamano, true);
+    }
+
+    if (actualizar) {
+        GuardarHoja(tamano, &hoja);
+    }
+    free(hoja.pixeles);
+}
+
+/* === Public function implementation ============================================================================== */
+
+int main(int argc, char * argv[]) {
+    bus_falso_estadisticas_t bus;
+    bool registrar = false;
+
+    for (int indice = 1; indice < argc; indice++) {
+        actualizar = actualizar || (strcmp(argv[indice], "--actualizar") == 0);
+        registrar = registrar || (strcmp(argv[indice], "--registrar") == 0);
+    }
+
+    ILI9341Init();
+    if (registrar) {
+        for (int indice = 0; indice < sizeof(TAMANOS) / sizeof(TAMANOS[0]); indice++) {
+            VERIFICAR(RegistrarGeometria(&TAMANOS[indice].geometria), "%s: no se pudo registrar",
+                      TAMANOS[indice].nombre);
+        }
+    }
+    if (!actualizar) {
+        LeerPresupuestos();
+    }
+
+    for (int indice = 0; indice < sizeof(TAMANOS) / sizeof(TAMANOS[0]); indice++) {
+        ProbarTamano(&TAMANOS[indice]);
+    }
+
+    if (actualizar) {
+        GuardarPresupuestos();
+    }
+    BusFalsoLeerEstadisticas(&bus);
+    VERIFICAR(bus.errores == 0, "el bus rechazó %u transacciones", bus.errores);
+    return RESULTADO();
+}
+
+/* === End of documentation ======================================================================================== */
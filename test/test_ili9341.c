@@ -0,0 +1,316 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+
+/** @file test_ili9341.c
+ ** @brief Prueba de la lectura de la memoria de imagen, los sprites y las superficies del driver ILI9341
+ **
+ ** Los colores leídos con ILI9341ReadRect tienen que ser los escritos, la lectura no puede tocar el bus dentro de un
+ ** lote y las escrituras siguientes tienen que volver al reloj que eligió la calibración. Los sprites se recortan a la
+ ** pantalla y dejan sin tocar lo que está debajo de sus pixeles transparentes. Las superficies llegan a la pantalla
+ ** con los colores de su paleta con cualquier profundidad y una superficie vacía no envía nada.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "bus_falso.h"
+#include "prueba.h"
+#include "ili9341.h"
+
+/* === Macros definitions ========================================================================================== */
+
+#define ANCHO 40 //!< Columnas del rectángulo que se escribe y se lee
+#define ALTO  12 //!< Filas del rectángulo que se escribe y se lee
+
+#define SPRITE_ANCHO 13     //!< Columnas de los sprites de prueba
+#define SPRITE_ALTO  7      //!< Filas de los sprites de prueba
+#define COLOR_FONDO  0x1234 //!< Color de la memoria de imagen debajo de los sprites
+#define COLOR_CLAVE  0xF81F //!< Color transparente del sprite RGB565
+
+#define SUPERFICIE_ANCHO 21  //!< Columnas de las superficies de prueba, no completan el último byte de cada fila
+#define SUPERFICIE_ALTO  5   //!< Filas de las superficies de prueba
+#define SUPERFICIE_X     10  //!< Columna de la pantalla donde se envían las superficies
+#define SUPERFICIE_Y     200 //!< Fila de la pantalla donde se envían las superficies
+
+/* === Private data type declarations ============================================================================== */
+
+/* === Private variable declarations =============================================================================== */
+
+/* === Private function declarations =============================================================================== */
+
+/* === Public variable definitions ================================================================================= */
+
+int fallas;
+
+/* === Private variable definitions ================================================================================ */
+
+static uint16_t escritos[ANCHO * ALTO];
+static uint16_t leidos[ANCHO * ALTO];
+
+static uint16_t sprite_colores[SPRITE_ANCHO * SPRITE_ALTO];
+static uint8_t sprite_indices[SPRITE_ANCHO * SPRITE_ALTO];
+
+static uint8_t superficie_datos[ILI9341_SURFACE_SIZE(SUPERFICIE_ANCHO, SUPERFICIE_ALTO, 8)];
+static uint16_t superficie_paleta[256];
+
+//! Paleta del sprite indexado, la entrada cero es la transparente
+static const uint16_t PALETA_SPRITE[] = {0x0000, ILI9341_RED, ILI9341_GREEN, ILI9341_BLUE};
+
+//! Posiciones de los sprites, dentro de la pantalla y recortados por cada borde
+static const struct {
+    int16_t x;
+    int16_t y;
+} POSICIONES[] = {
+    {20, 30},
+    {-5, -3},
+    {ILI9341_WIDTH - 6, 100},
+    {100, ILI9341_HEIGHT - 4},
+    {ILI9341_WIDTH - 2, ILI9341_HEIGHT - 2},
+};
+
+/* === Private function definitions ================================================================================ */
+
+// Todos los bits de cada componente del color tienen que ir y volver, la lectura usa más de un fragmento
+static void ProbarLectura(void) {
+    for (int indice = 0; indice < ANCHO * ALTO; indice++) {
+        escritos[indice] = (indice * 0x9E37) ^ (indice >> 3);
+        leidos[indice] = ~escritos[indice];
+    }
+    for (int fila = 0; fila < ALTO; fila++) {
+        for (int columna = 0; columna < ANCHO; columna++) {
+            ILI9341DrawPixel(30 + columna, 50 + fila, escritos[fila * ANCHO + columna]);
+        }
+    }
+
+    VERIFICAR(ILI9341ReadRect(30, 50, 30 + ANCHO - 1, 50 + ALTO - 1, leidos) == ESP_OK, "la lectura falló");
+    for (int indice = 0; indice < ANCHO * ALTO; indice++) {
+        if (leidos[indice] != escritos[indice]) {
+            VERIFICAR(false, "el pixel %d,%d se leyó %04X y se escribió %04X", indice % ANCHO, indice / ANCHO,
+                      leidos[indice], escritos[indice]);
+            break;
+        }
+    }
+}
+
+// Dentro de un lote la lectura se rechaza sin enviar nada, el bus no se puede soltar para cambiar el reloj
+static void ProbarLote(void) {
+    bus_falso_estadisticas_t bus;
+
+    ILI9341StartBatch();
+    BusFalsoBorrarEstadisticas();
+    VERIFICAR(ILI9341ReadRect(30, 50, 30 + ANCHO - 1, 50 + ALTO - 1, leidos) == ESP_ERR_INVALID_STATE,
+              "la lectura dentro de un lote no se rechazó");
+    BusFalsoLeerEstadisticas(&bus);
+    VERIFICAR((bus.transacciones == 0) && (bus.conexiones == 0), "la lectura rechazada usó el bus");
+    ILI9341EndBatch();
+}
+
+// Después de leer, las escrituras vuelven al reloj de la calibración
+static void ProbarReloj(int reloj) {
+    bus_falso_estadisticas_t bus;
+    uint64_t esperado;
+
+    ILI9341ReadRect(30, 50, 30 + ANCHO - 1, 50 + ALTO - 1, leidos);
+    BusFalsoBorrarEstadisticas();
+    ILI9341DrawFilledRectangle(0, 0, 99, 99, ILI9341_RED);
+    BusFalsoLeerEstadisticas(&bus);
+    esperado = bus.bits * 1000000000u / reloj;
+    VERIFICAR((bus.tiempo_ns + bus.transacciones >= esperado) && (bus.tiempo_ns <= esperado),
+              "después de leer las escrituras tardan %llu ns y a %d Hz tardarían %llu ns",
+              (unsigned long long)bus.tiempo_ns, reloj, (unsigned long long)esperado);
+}
+
+// Un pixel es transparente en las diagonales, en la fila 2 completa y nunca en la fila 4
+static bool SpriteOpaco(int fila, int columna) {
+    return (fila == 4) || ((fila != 2) && ((fila + 2 * columna) % 5 != 0));
+}
+
+static void CrearSprites(ili9341_sprite_t * rgb, ili9341_sprite_t * indexado) {
+    for (int fila = 0; fila < SPRITE_ALTO; fila++) {
+        for (int columna = 0; columna < SPRITE_ANCHO; columna++) {
+            int indice = fila * SPRITE_ANCHO + columna;
+            sprite_indices[indice] = SpriteOpaco(fila, columna) ? 1 + indice % 3 : 0;
+            sprite_colores[indice] = SpriteOpaco(fila, columna) ? 0x0841 * (indice % 31) + 1 : COLOR_CLAVE;
+        }
+    }
+    *rgb = (ili9341_sprite_t){SPRITE_ANCHO, SPRITE_ALTO, ILI9341_SPRITE_RGB565, sprite_colores, NULL, COLOR_CLAVE};
+    *indexado = (ili9341_sprite_t){SPRITE_ANCHO, SPRITE_ALTO, ILI9341_SPRITE_INDEXED, sprite_indices, PALETA_SPRITE, 0};
+}
+
+// Color que tiene que quedar en un pixel de la pantalla después de dibujar el sprite en x, y
+static uint16_t SpriteEsperado(const ili9341_sprite_t * sprite, int16_t x, int16_t y, int columna, int fila) {
+    int indice = (fila - y) * SPRITE_ANCHO + (columna - x);
+
+    if ((columna < x) || (columna >= x + SPRITE_ANCHO) || (fila < y) || (fila >= y + SPRITE_ALTO) ||
+        (columna >= ILI9341_WIDTH) || (fila >= ILI9341_HEIGHT) || !SpriteOpaco(fila - y, columna - x)) {
+        return COLOR_FONDO;
+    }
+    if (sprite->format == ILI9341_SPRITE_INDEXED) {
+        return PALETA_SPRITE[sprite_indices[indice]];
+    }
+    return sprite_colores[indice];
+}
+
+// Cada tramo opaco recortado a la pantalla es una ventana de una fila, debajo de la clave queda el fondo
+static void ProbarSprite(const ili9341_sprite_t * sprite, const char * nombre) {
+    ili9341_stats_t medido;
+    uint32_t tramos, opacos, distintos;
+    bool anterior;
+
+    for (size_t posicion = 0; posicion < sizeof(POSICIONES) / sizeof(POSICIONES[0]); posicion++) {
+        int16_t x = POSICIONES[posicion].x, y = POSICIONES[posicion].y;
+
+        tramos = 0;
+        opacos = 0;
+        for (int fila = (y < 0) ? -y : 0; (fila < SPRITE_ALTO) && (y + fila < ILI9341_HEIGHT); fila++) {
+            anterior = false;
+            for (int columna = (x < 0) ? -x : 0; (columna < SPRITE_ANCHO) && (x + columna < ILI9341_WIDTH);
+                 columna++) {
+                tramos += SpriteOpaco(fila, columna) && !anterior;
+                opacos += SpriteOpaco(fila, columna);
+                anterior = SpriteOpaco(fila, columna);
+            }
+        }
+
+        BusFalsoLlenar(COLOR_FONDO);
+        ILI9341ResetStats();
+        ILI9341DrawSprite(x, y, sprite);
+        ILI9341GetStats(&medido);
+        VERIFICAR((medido.windows == tramos) && (medido.bytes == 8 * tramos + 2 * opacos),
+                  "sprite %s en %d,%d: %u ventanas y %u bytes, se esperaban %u tramos con %u pixeles", nombre, x, y,
+                  medido.windows, medido.bytes, tramos, opacos);
+
+        distintos = 0;
+        for (int fila = (y < 2) ? 0 : y - 2; (fila < y + SPRITE_ALTO + 2) && (fila < BUS_FALSO_LADO); fila++) {
+            for (int columna = (x < 2) ? 0 : x - 2; (columna < x + SPRITE_ANCHO + 2) && (columna < BUS_FALSO_LADO);
+                 columna++) {
+                distintos += BusFalsoPixel(columna, fila) != SpriteEsperado(sprite, x, y, columna, fila);
+            }
+        }
+        VERIFICAR(distintos == 0, "sprite %s en %d,%d: %u pixeles distintos de los esperados", nombre, x, y,
+                  distintos);
+    }
+}
+
+// Índice de paleta de cada pixel de las superficies, recorre todas las entradas
+static uint8_t SuperficieIndice(int columna, int fila, uint8_t bpp) {
+    return (columna * 3 + fila * 7) % (1 << bpp);
+}
+
+// Compara la pantalla con la superficie expandida con su paleta, alrededor tiene que quedar el fondo
+static uint32_t SuperficieDistintos(const ili9341_surface_t * superficie) {
+    uint32_t distintos = 0;
+    uint16_t esperado;
+
+    for (int fila = SUPERFICIE_Y - 1; fila <= SUPERFICIE_Y + SUPERFICIE_ALTO; fila++) {
+        for (int columna = SUPERFICIE_X - 1; columna <= SUPERFICIE_X + SUPERFICIE_ANCHO; columna++) {
+            esperado = COLOR_FONDO;
+            if ((columna >= SUPERFICIE_X) && (columna < SUPERFICIE_X + superficie->width) && (fila >= SUPERFICIE_Y) &&
+                (fila < SUPERFICIE_Y + superficie->height)) {
+                esperado = superficie->palette[SuperficieIndice(columna - SUPERFICIE_X, fila - SUPERFICIE_Y,
+                                                                superficie->bpp)];
+            }
+            distintos += BusFalsoPixel(columna, fila) != esperado;
+        }
+    }
+    return distintos;
+}
+
+// Con cada profundidad la pantalla recibe los colores de la paleta, también después de reescribirla
+static void ProbarSuperficie(uint8_t bpp) {
+    ili9341_surface_t superficie;
+    ili9341_stats_t medido;
+    uint32_t leidos = 0;
+
+    ILI9341SurfaceInit(&superficie, SUPERFICIE_ANCHO, SUPERFICIE_ALTO, bpp, superficie_datos, superficie_paleta);
+    for (int indice = 0; indice < (1 << bpp); indice++) {
+        ILI9341SurfaceSetPalette(&superficie, indice, 0x1111 * (indice % 15 + 1) + indice / 15);
+    }
+    for (int fila = 0; fila < SUPERFICIE_ALTO; fila++) {
+        for (int columna = 0; columna < SUPERFICIE_ANCHO; columna++) {
+            ILI9341SurfaceSetPixel(&superficie, columna, fila, SuperficieIndice(columna, fila, bpp));
+        }
+    }
+    for (int fila = 0; fila < SUPERFICIE_ALTO; fila++) {
+        for (int columna = 0; columna < SUPERFICIE_ANCHO; columna++) {
+            leidos += ILI9341SurfaceGetPixel(&superficie, columna, fila) != SuperficieIndice(columna, fila, bpp);
+        }
+    }
+    VERIFICAR(leidos == 0, "superficie de %u bpp: %u pixeles no devuelven el índice escrito", bpp, leidos);
+
+    BusFalsoLlenar(COLOR_FONDO);
+    ILI9341ResetStats();
+    ILI9341SurfaceFlush(&superficie, SUPERFICIE_X, SUPERFICIE_Y);
+    ILI9341GetStats(&medido);
+    VERIFICAR((medido.windows == 1) && (medido.bytes == 8 + 2 * SUPERFICIE_ANCHO * SUPERFICIE_ALTO),
+              "superficie de %u bpp: %u ventanas y %u bytes", bpp, medido.windows, medido.bytes);
+    VERIFICAR(SuperficieDistintos(&superficie) == 0, "superficie de %u bpp: %u pixeles distintos de la paleta", bpp,
+              SuperficieDistintos(&superficie));
+
+    // Tema nocturno: solo cambia la paleta y se vuelve a enviar la superficie
+    for (int indice = 0; indice < (1 << bpp); indice++) {
+        ILI9341SurfaceSetPalette(&superficie, indice, (superficie_paleta[indice] >> 1) & 0x7BEF);
+    }
+    ILI9341SurfaceFlush(&superficie, SUPERFICIE_X, SUPERFICIE_Y);
+    VERIFICAR(SuperficieDistintos(&superficie) == 0, "superficie de %u bpp: %u pixeles distintos de la paleta nueva",
+              bpp, SuperficieDistintos(&superficie));
+}
+
+// Una superficie sin columnas o sin filas no envía nada, antes el recorte daba la vuelta y no terminaba
+static void ProbarSuperficieVacia(uint16_t ancho, uint16_t alto) {
+    bus_falso_estadisticas_t bus;
+    ili9341_surface_t superficie;
+
+    ILI9341SurfaceInit(&superficie, ancho, alto, 4, superficie_datos, superficie_paleta);
+    ILI9341SurfaceFillRectangle(&superficie, 0, 0, 3, 3, 1);
+    BusFalsoBorrarEstadisticas();
+    ILI9341SurfaceFlush(&superficie, SUPERFICIE_X, SUPERFICIE_Y);
+    ILI9341SurfaceFlushArea(&superficie, SUPERFICIE_X, SUPERFICIE_Y, 0, 0, 3, 3);
+    BusFalsoLeerEstadisticas(&bus);
+    VERIFICAR(bus.transacciones == 0, "la superficie de %ux%u envió %u transacciones", ancho, alto,
+              bus.transacciones);
+}
+
+/* === Public function implementation ============================================================================== */
+
+int main(void) {
+    bus_falso_estadisticas_t bus;
+    ili9341_sprite_t rgb, indexado;
+    int reloj;
+
+    ILI9341Init();
+    reloj = ILI9341Calibrate(true);
+    ProbarLectura();
+    ProbarLote();
+    ProbarReloj(reloj);
+    CrearSprites(&rgb, &indexado);
+    ProbarSprite(&rgb, "RGB565");
+    ProbarSprite(&indexado, "indexado");
+    for (uint8_t bpp = 1; bpp <= 8; bpp *= 2) {
+        ProbarSuperficie(bpp);
+    }
+    ProbarSuperficieVacia(0, SUPERFICIE_ALTO);
+    ProbarSuperficieVacia(SUPERFICIE_ANCHO, 0);
+    ProbarSuperficieVacia(0, 0);
+    BusFalsoLeerEstadisticas(&bus);
+    VERIFICAR(bus.errores == 0, "el bus rechazó %u transacciones", bus.errores);
+    return RESULTADO();
+}
+
+/* === End of documentation ======================================================================================== */
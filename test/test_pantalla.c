@@ -0,0 +1,386 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+
+/** @file test_pantalla.c
+ ** @brief Prueba de las pantallas de la tarea de la pantalla sobre el bus simulado
+ **
+ ** El archivo incluye display.c para usar sus pantallas y su renderizador sin la tarea, que depende de las colas de
+ ** FreeRTOS. Después de cada dibujo la memoria de imagen se compara con la misma pantalla dibujada desde cero sobre una
+ ** memoria que no se usó, que tiene que cubrir toda la pantalla:
+ **
+ ** - Al pasar de una pantalla a otra no quedan pixeles de la anterior.
+ ** - Una secuencia de valores, campos que parpadean y colores dibujada de a un cuadro por vez deja la misma imagen que
+ **   sus valores finales dibujados de una vez. Un cuadro sin cambios no envía nada y un segundo del reloj repinta una
+ **   sola celda.
+ ** - Las agujas de la esfera movidas de a un segundo durante más de una hora dejan la misma imagen que la esfera
+ **   dibujada completa, y ningún movimiento supera el presupuesto de un cuadro.
+ ** - La alarma destella con un único comando de inversión en cada cambio de fase, sin enviar pixeles, y el reloj se
+ **   sigue dibujando mientras la pantalla está invertida.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "display.c"
+#include "bus_falso.h"
+#include "prueba.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* === Macros definitions ========================================================================================== */
+
+#define COLOR_VACIO 0x1234 //!< Color de la memoria antes de dibujar, no lo usa ninguna pantalla
+
+#define CUADROS_SECUENCIA   2000 //!< Cuadros de la secuencia de valores de cada pantalla
+#define CUADROS_COMPARACION 97   //!< Cuadros entre dos comparaciones con la pantalla dibujada desde cero
+#define SEGUNDOS_AGUJAS     3700 //!< Segundos que se mueven las agujas de la esfera
+
+/* === Private data type declarations ============================================================================== */
+
+//! @brief Imagen de toda la pantalla
+typedef uint16_t imagen_t[ILI9341_HEIGHT][ILI9341_WIDTH];
+
+//! @brief Estado que la tarea de la pantalla le pasa al renderizador en cada cuadro
+typedef struct {
+    int32_t valores[CANTIDAD_FUENTES]; //!< Valor de cada fuente
+    int campo_oculto;                  //!< Campo del reloj oculto por el parpadeo, -1 si ninguno
+    uint16_t colores[CANTIDAD_FUENTES]; //!< Color de los widgets de cada fuente, 0 para el de la tabla
+} cuadro_t;
+
+/* === Private variable declarations =============================================================================== */
+
+static const char * const NOMBRES[] = {
+    [PANTALLA_RELOJ] = "reloj",
+    [PANTALLA_CRONO] = "cronometro",
+    [PANTALLA_ESTADISTICAS] = "estadisticas",
+    [PANTALLA_ANALOGICA] = "analogica",
+};
+
+/* === Private function declarations =============================================================================== */
+
+/* === Public variable definitions ================================================================================= */
+
+int fallas;
+
+/* === Private variable definitions ================================================================================ */
+
+static imagen_t obtenida; //!< Pantalla dibujada por la prueba
+static imagen_t esperada; //!< La misma pantalla dibujada desde cero
+
+/* === Private function definitions ================================================================================ */
+
+static void Capturar(imagen_t imagen) {
+    for (int y = 0; y < ILI9341_HEIGHT; y++) {
+        for (int x = 0; x < ILI9341_WIDTH; x++) {
+            imagen[y][x] = BusFalsoPixel(x, y);
+        }
+    }
+}
+
+static void Comparar(const char * descripcion) {
+    int diferentes = 0, x0 = 0, y0 = 0;
+
+    for (int y = 0; y < ILI9341_HEIGHT; y++) {
+        for (int x = 0; x < ILI9341_WIDTH; x++) {
+            if ((obtenida[y][x] != esperada[y][x]) && (diferentes++ == 0)) {
+                x0 = x;
+                y0 = y;
+            }
+        }
+    }
+    VERIFICAR(diferentes == 0, "%s: %d pixeles distintos de la pantalla dibujada desde cero, el primero %d,%d es %04X y "
+              "se esperaba %04X", descripcion, diferentes, x0, y0, obtenida[y0][x0], esperada[y0][x0]);
+}
+
+static void Colorear(const cuadro_t * cuadro) {
+    for (int fuente = 0; fuente < CANTIDAD_FUENTES; fuente++) {
+        for (int i = 0; i < PANTALLAS[pantalla].cantidad; i++) {
+            if (PANTALLAS[pantalla].widgets[i].fuente == fuente) {
+                colorear(fuente, cuadro->colores[fuente] ? cuadro->colores[fuente]
+                                                         : PANTALLAS[pantalla].widgets[i].encendido);
+            }
+        }
+    }
+}
+
+// Cambia de pantalla como la tarea, que dibuja la esfera al mostrar el reloj analógico
+static void Mostrar(int numero, const cuadro_t * cuadro) {
+    if (usar_pantalla(numero) && (numero == PANTALLA_ANALOGICA)) {
+        DibujarEsfera();
+    }
+    Colorear(cuadro);
+    renderizar(cuadro->valores, cuadro->campo_oculto, 0);
+}
+
+// Dibuja la pantalla desde cero en la imagen esperada y verifica que no quedó ningún pixel sin pintar
+static void DibujarDesdeCero(int numero, const cuadro_t * cuadro) {
+    usar_pantalla(PANTALLA_NINGUNA);
+    BusFalsoLlenar(COLOR_VACIO);
+    Mostrar(numero, cuadro);
+    Capturar(esperada);
+
+    for (int y = 0; y < ILI9341_HEIGHT; y++) {
+        for (int x = 0; x < ILI9341_WIDTH; x++) {
+            if (esperada[y][x] == COLOR_VACIO) {
+                VERIFICAR(false, "%s: el pixel %d,%d quedó sin pintar", NOMBRES[numero], x, y);
+                return;
+            }
+        }
+    }
+}
+
+static void CuadroInicial(cuadro_t * cuadro) {
+    memset(cuadro, 0, sizeof(*cuadro));
+    cuadro->valores[FUENTE_TIEMPO] = 235958;
+    cuadro->valores[FUENTE_DIA] = 31;
+    cuadro->valores[FUENTE_MES] = 12;
+    cuadro->valores[FUENTE_YEAR] = 2025;
+    cuadro->valores[FUENTE_CRONO] = 8765;
+    for (int i = 0; i < VUELTAS_VISIBLES; i++) {
+        cuadro->valores[FUENTE_PARCIAL + i] = 1234 - 111 * i;
+    }
+    cuadro->valores[FUENTE_VUELTA] = -1;
+    cuadro->valores[FUENTE_MEJOR] = 1012;
+    cuadro->valores[FUENTE_PEOR] = 1234;
+    cuadro->valores[FUENTE_MEDIA] = 1123;
+    cuadro->valores[FUENTE_DESVIO] = 91;
+    cuadro->valores[FUENTE_DELTA] = -111;
+    cuadro->valores[FUENTE_CANTIDAD] = 12;
+    cuadro->campo_oculto = -1;
+}
+
+// Cada pantalla se muestra después de cada una de las otras y se compara con la misma pantalla dibujada desde cero
+static void ProbarCambios(void) {
+    char descripcion[64];
+    cuadro_t cuadro;
+
+    CuadroInicial(&cuadro);
+    for (int anterior = PANTALLA_RELOJ; anterior <= PANTALLA_ANALOGICA; anterior++) {
+        for (int siguiente = PANTALLA_RELOJ; siguiente <= PANTALLA_ANALOGICA; siguiente++) {
+            if (anterior == siguiente) {
+                continue;
+            }
+            DibujarDesdeCero(anterior, &cuadro);
+            Mostrar(siguiente, &cuadro);
+            Capturar(obtenida);
+            DibujarDesdeCero(siguiente, &cuadro);
+            snprintf(descripcion, sizeof(descripcion), "%s después de %s", NOMBRES[siguiente], NOMBRES[anterior]);
+            Comparar(descripcion);
+        }
+    }
+}
+
+// Cambia al azar los valores que muestra la pantalla, como lo harían los mensajes que recibe la tarea
+static void CambiarCuadro(int numero, cuadro_t * cuadro) {
+    static const uint16_t COLORES[] = {0, DIGITO_ENCENDIDO_PAUSA, DIGITO_ENCENDIDO_MEJOR, DIGITO_ENCENDIDO_PEOR};
+    int fuente;
+
+    switch (rand() % 4) {
+    case 0:
+        fuente = (numero == PANTALLA_CRONO) ? FUENTE_CRONO : FUENTE_TIEMPO;
+        cuadro->valores[fuente] = (cuadro->valores[fuente] + 1) % 240000;
+        break;
+    case 1:
+        fuente = rand() % (FUENTE_ETIQUETA + 1);
+        cuadro->valores[fuente] = rand() % 10000;
+        break;
+    case 2:
+        cuadro->campo_oculto = (numero == PANTALLA_RELOJ) ? rand() % 7 - 1 : -1;
+        break;
+    default:
+        fuente = (rand() % 2) ? FUENTE_CRONO : FUENTE_PARCIAL + rand() % VUELTAS_VISIBLES;
+        cuadro->colores[fuente] = (numero == PANTALLA_CRONO) ? COLORES[rand() % 4] : 0;
+        break;
+    }
+    cuadro->valores[FUENTE_VUELTA] = (cuadro->valores[FUENTE_VUELTA] % 100) ? -1 : cuadro->valores[FUENTE_VUELTA];
+    cuadro->valores[FUENTE_MODO] = cuadro->valores[FUENTE_MODO] % 5;
+}
+
+// Una secuencia de cuadros dibujada de a uno tiene que dejar la pantalla igual que su último cuadro dibujado de una vez
+static void ProbarSecuencia(int numero) {
+    char descripcion[64];
+    cuadro_t cuadro;
+
+    srand(numero);
+    CuadroInicial(&cuadro);
+    DibujarDesdeCero(numero, &cuadro);
+    for (int indice = 1; indice <= CUADROS_SECUENCIA; indice++) {
+        CambiarCuadro(numero, &cuadro);
+        Colorear(&cuadro);
+        renderizar(cuadro.valores, cuadro.campo_oculto, 0);
+        if (indice % CUADROS_COMPARACION == 0) {
+            Capturar(obtenida);
+            DibujarDesdeCero(numero, &cuadro);
+            snprintf(descripcion, sizeof(descripcion), "%s en el cuadro %d", NOMBRES[numero], indice);
+            Comparar(descripcion);
+        }
+    }
+}
+
+// Un cuadro sin cambios no envía nada y un segundo del reloj, salvo los que cambian las decenas, pinta una sola celda
+static void ProbarTrafico(void) {
+    const rectangulo_t * segundos = &CAMPOS_RELOJ[2];
+    bus_falso_estadisticas_t bus;
+    ili9341_stats_t trafico;
+    cuadro_t cuadro;
+
+    CuadroInicial(&cuadro);
+    cuadro.valores[FUENTE_TIEMPO] = 101530;
+    DibujarDesdeCero(PANTALLA_RELOJ, &cuadro);
+
+    BusFalsoBorrarEstadisticas();
+    renderizar(cuadro.valores, cuadro.campo_oculto, 0);
+    BusFalsoLeerEstadisticas(&bus);
+    VERIFICAR(bus.transacciones == 0, "un cuadro sin cambios envió %u transacciones", bus.transacciones);
+
+    cuadro.valores[FUENTE_TIEMPO]++;
+    Capturar(esperada);
+    ILI9341ResetStats();
+    renderizar(cuadro.valores, cuadro.campo_oculto, 0);
+    ILI9341GetStats(&trafico);
+    Capturar(obtenida);
+    for (int y = 0; y < ILI9341_HEIGHT; y++) {
+        for (int x = 0; x < ILI9341_WIDTH; x++) {
+            if ((obtenida[y][x] != esperada[y][x]) &&
+                ((x < segundos->x0 + DIGITO_ANCHO_A) || (x > segundos->x1) || (y < segundos->y0) || (y > segundos->y1))) {
+                VERIFICAR(false, "un segundo del reloj cambió el pixel %d,%d, fuera de la celda de las unidades", x, y);
+                y = ILI9341_HEIGHT;
+                break;
+            }
+        }
+    }
+    VERIFICAR(trafico.bytes <= 2 * (DIGITO_ANCHO_A + 1) * (DIGITO_ALTO_A + 1),
+              "un segundo del reloj envió %u bytes, más que una celda", trafico.bytes);
+}
+
+// Las agujas se mueven de a un segundo y cada tanto se comparan con la esfera dibujada completa
+static void ProbarAgujas(void) {
+    ili9341_stats_t trafico, maximo = {0};
+    int hora = 10, minuto = 8, segundo = 0;
+    char descripcion[64];
+    cuadro_t cuadro;
+
+    CuadroInicial(&cuadro);
+    DibujarDesdeCero(PANTALLA_ANALOGICA, &cuadro);
+    MoverAgujas(hora, minuto, segundo);
+    for (int indice = 1; indice <= SEGUNDOS_AGUJAS; indice++) {
+        segundo = (segundo + 1) % 60;
+        minuto = (minuto + (segundo == 0)) % 60;
+        hora = (hora + ((minuto == 0) && (segundo == 0))) % 24;
+
+        ILI9341ResetStats();
+        MoverAgujas(hora, minuto, segundo);
+        ILI9341GetStats(&trafico);
+        maximo.windows = (trafico.windows > maximo.windows) ? trafico.windows : maximo.windows;
+        maximo.bytes = (trafico.bytes > maximo.bytes) ? trafico.bytes : maximo.bytes;
+
+        if (indice % CUADROS_COMPARACION == 0) {
+            Capturar(obtenida);
+            DibujarEsfera();
+            Capturar(esperada);
+            snprintf(descripcion, sizeof(descripcion), "agujas a las %02d:%02d:%02d", hora, minuto, segundo);
+            Comparar(descripcion);
+        }
+    }
+    printf("agujas: a lo sumo %u ventanas y %u bytes por segundo\n", maximo.windows, maximo.bytes);
+    VERIFICAR(maximo.windows <= PRESUPUESTO_VENTANAS, "las agujas abrieron %u ventanas en un segundo", maximo.windows);
+    VERIFICAR(maximo.bytes <= PRESUPUESTO_BYTES, "las agujas enviaron %u bytes en un segundo", maximo.bytes);
+}
+
+// La alarma destella con un comando de inversión por fase, sin pixeles, y el reloj se sigue dibujando invertido
+static void ProbarAlarma(void) {
+    //! Fases del parpadeo, la alarma se apaga con la pantalla invertida y tiene que volver a los colores normales
+    static const struct {
+        int modo;
+        bool visible;
+    } FASES[] = {
+        {MODO_ALARM, false}, {MODO_ALARM, true}, {MODO_ALARM, false}, {MODO_ALARM, true},
+        {MODO_ALARM, false}, {MODO_CLOCK, false}, {MODO_CLOCK, true},
+    };
+    bus_falso_estadisticas_t bus;
+    ili9341_stats_t trafico;
+    bool esperada, anterior = false;
+    cuadro_t cuadro;
+
+    CuadroInicial(&cuadro);
+    cuadro.valores[FUENTE_TIEMPO] = 70000;
+    DibujarDesdeCero(PANTALLA_RELOJ, &cuadro);
+    for (size_t fase = 0; fase < sizeof(FASES) / sizeof(FASES[0]); fase++) {
+        parpadeo_visible = FASES[fase].visible;
+        esperada = (FASES[fase].modo == MODO_ALARM) && !FASES[fase].visible;
+        cuadro.valores[FUENTE_TIEMPO]++;
+
+        BusFalsoBorrarEstadisticas();
+        ILI9341ResetStats();
+        destellar_alarma(FASES[fase].modo);
+        BusFalsoLeerEstadisticas(&bus);
+        ILI9341GetStats(&trafico);
+        VERIFICAR(BusFalsoInvertida() == esperada, "en la fase %zu la pantalla %sestá invertida", fase,
+                  BusFalsoInvertida() ? "" : "no ");
+        VERIFICAR(bus.transacciones == (esperada != anterior), "la fase %zu envió %u transacciones", fase,
+                  bus.transacciones);
+        VERIFICAR((trafico.windows == 0) && (trafico.bytes == 0), "la fase %zu envió %u ventanas y %u bytes", fase,
+                  trafico.windows, trafico.bytes);
+        anterior = esperada;
+
+        // Otro cuadro en la misma fase no vuelve a enviar el comando
+        BusFalsoBorrarEstadisticas();
+        destellar_alarma(FASES[fase].modo);
+        BusFalsoLeerEstadisticas(&bus);
+        VERIFICAR(bus.transacciones == 0, "repetir la fase %zu envió %u transacciones", fase, bus.transacciones);
+
+        ILI9341ResetStats();
+        renderizar(cuadro.valores, cuadro.campo_oculto, 0);
+        ILI9341GetStats(&trafico);
+        VERIFICAR(trafico.bytes > 0, "en la fase %zu no se dibujó el segundo del reloj", fase);
+    }
+    parpadeo_visible = true;
+
+    // La inversión es del controlador, la memoria de imagen tiene el reloj que se dibujó durante la alarma
+    Capturar(obtenida);
+    DibujarDesdeCero(PANTALLA_RELOJ, &cuadro);
+    Comparar("reloj después de la alarma");
+}
+
+/* === Public function implementation ============================================================================== */
+
+int main(void) {
+    bus_falso_estadisticas_t bus;
+
+    ILI9341Init();
+    ILI9341Rotate(ILI9341_Portrait_2);
+    for (int i = 0; i < sizeof(GEOMETRIAS) / sizeof(GEOMETRIAS[0]); i++) {
+        RegistrarGeometria(&GEOMETRIAS[i]);
+    }
+    VERIFICAR(CrearEsfera(ESFERA_X, ESFERA_Y, ESFERA_RADIO, &COLORES_ESFERA), "no se pudo crear la esfera");
+
+    ProbarCambios();
+    for (int numero = PANTALLA_RELOJ; numero <= PANTALLA_ANALOGICA; numero++) {
+        ProbarSecuencia(numero);
+    }
+    ProbarTrafico();
+    ProbarAgujas();
+    ProbarAlarma();
+
+    BusFalsoLeerEstadisticas(&bus);
+    VERIFICAR(bus.errores == 0, "el bus rechazó %u transacciones", bus.errores);
+    return RESULTADO();
+}
+
+/* === End of documentation ======================================================================================== */
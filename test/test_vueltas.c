@@ -0,0 +1,270 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+
+/** @file test_vueltas.c
+ ** @brief Prueba del anillo de vueltas del cronómetro y de la ventana que muestra la pantalla
+ **
+ ** Las vueltas se agregan con vueltas_agregar y se leen con vueltas_vista, que tiene que devolver las filas de la más
+ ** nueva a la más vieja aunque el anillo ya haya dado la vuelta. vueltas_desplazar mueve la ventana como el botón de
+ ** las vueltas y la mejor y la peor solo se resaltan cuando están en la ventana. Las estadísticas que se actualizan con
+ ** cada vuelta tienen que coincidir con las calculadas recorriendo todas las duraciones.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "prueba.h"
+#include "time_struct.h"
+
+/* === Macros definitions ========================================================================================== */
+
+#define VUELTAS_PRUEBA 130   //!< Vueltas tomadas en la prueba del anillo, más de las que caben
+#define TOLERANCIA     1e-4  //!< Error relativo aceptado en la media y la varianza, que se acumulan en float
+
+/* === Private data type declarations ============================================================================== */
+
+/* === Private variable declarations =============================================================================== */
+
+/* === Private function declarations =============================================================================== */
+
+/* === Public variable definitions ================================================================================= */
+
+int fallas;
+
+/* === Private variable definitions ================================================================================ */
+
+static vueltas anillo;
+
+//! Parciales de cada vuelta en décimas, el índice es el número de la vuelta
+static int parciales[VUELTAS_PRUEBA + 1];
+
+/* === Private function definitions ================================================================================ */
+
+// Tiempo del cronómetro con las décimas dadas
+static time_struct Parcial(int decimas) {
+    time_struct parcial = {decimas % 10, decimas / 10 % 10, decimas / 100 % 10, decimas / 1000 % 10};
+    return parcial;
+}
+
+// Toma las vueltas con las duraciones dadas desde un cronómetro en cero y guarda sus parciales
+static void TomarVueltas(const int * duraciones, int cantidad) {
+    vueltas_cero(&anillo);
+    parciales[0] = 0;
+    for (int numero = 1; numero <= cantidad; numero++) {
+        parciales[numero] = parciales[numero - 1] + duraciones[numero - 1];
+        vueltas_agregar(&anillo, Parcial(parciales[numero]));
+    }
+}
+
+// Verifica que cada fila de la ventana tiene el parcial de su vuelta y que después de la más vieja hay ceros
+static void VerificarVista(int desplazamiento) {
+    vista_vueltas vista;
+    int numero;
+
+    vueltas_vista(&anillo, desplazamiento, &vista);
+    VERIFICAR(vista.primera == anillo.total - desplazamiento, "con %d vueltas y desplazamiento %d la primera es %d",
+              anillo.total, desplazamiento, vista.primera);
+    VERIFICAR(vista.desplazada == (desplazamiento > 0), "con desplazamiento %d la ventana %sestá desplazada",
+              desplazamiento, vista.desplazada ? "" : "no ");
+    for (int fila = 0; fila < VUELTAS_VISIBLES; fila++) {
+        numero = vista.primera - fila;
+        if (desplazamiento + fila < anillo.cantidad) {
+            VERIFICAR(time_decimas(&vista.filas[fila]) == parciales[numero],
+                      "con %d vueltas y desplazamiento %d la fila %d tiene %d y la vuelta %d es %d", anillo.total,
+                      desplazamiento, fila, time_decimas(&vista.filas[fila]), numero, parciales[numero]);
+        } else {
+            VERIFICAR(time_decimas(&vista.filas[fila]) == 0,
+                      "con %d vueltas y desplazamiento %d la fila %d vacía tiene %d", anillo.total, desplazamiento,
+                      fila, time_decimas(&vista.filas[fila]));
+        }
+    }
+}
+
+// Más vueltas que la capacidad: el anillo guarda las últimas y todas las ventanas posibles las muestran en orden
+static void ProbarAnillo(void) {
+    int duraciones[VUELTAS_PRUEBA];
+
+    for (int indice = 0; indice < VUELTAS_PRUEBA; indice++) {
+        duraciones[indice] = 20 + indice % 7;
+    }
+    TomarVueltas(duraciones, VUELTAS_PRUEBA);
+    VERIFICAR((anillo.cantidad == VUELTAS_CAPACIDAD) && (anillo.total == VUELTAS_PRUEBA),
+              "después de %d vueltas el anillo guarda %d de %d", VUELTAS_PRUEBA, anillo.cantidad, anillo.total);
+    for (int desplazamiento = 0; desplazamiento + VUELTAS_VISIBLES <= VUELTAS_CAPACIDAD; desplazamiento++) {
+        VerificarVista(desplazamiento);
+    }
+}
+
+// Con menos vueltas que filas, las filas siguientes a la más vieja quedan en cero
+static void ProbarPocas(void) {
+    static const int DURACIONES[] = {35, 41};
+    vista_vueltas vista;
+
+    for (int cantidad = 0; cantidad <= 2; cantidad++) {
+        TomarVueltas(DURACIONES, cantidad);
+        VerificarVista(0);
+        vueltas_vista(&anillo, 0, &vista);
+        VERIFICAR((vista.mejor == -1) == (cantidad < 2) && (vista.peor == -1) == (cantidad < 2),
+                  "con %d vueltas la mejor está en la fila %d y la peor en la %d", cantidad, vista.mejor, vista.peor);
+    }
+}
+
+// La ventana baja de a una vuelta y vuelve a cero cuando su última fila es la vuelta más vieja guardada
+static void ProbarDesplazar(void) {
+    static const int CANTIDADES[] = {0, 1, VUELTAS_VISIBLES, VUELTAS_VISIBLES + 2, VUELTAS_PRUEBA};
+    int duraciones[VUELTAS_PRUEBA];
+    int desplazamiento, pasos;
+
+    for (int indice = 0; indice < VUELTAS_PRUEBA; indice++) {
+        duraciones[indice] = 30;
+    }
+    for (size_t indice = 0; indice < sizeof(CANTIDADES) / sizeof(CANTIDADES[0]); indice++) {
+        TomarVueltas(duraciones, CANTIDADES[indice]);
+        desplazamiento = 0;
+        pasos = 0;
+        do {
+            VERIFICAR(desplazamiento + VUELTAS_VISIBLES <= anillo.cantidad || desplazamiento == 0,
+                      "con %d vueltas guardadas el desplazamiento llegó a %d", anillo.cantidad, desplazamiento);
+            desplazamiento = vueltas_desplazar(&anillo, desplazamiento);
+            pasos++;
+        } while ((desplazamiento != 0) && (pasos <= VUELTAS_CAPACIDAD));
+        VERIFICAR(pasos == ((anillo.cantidad > VUELTAS_VISIBLES) ? anillo.cantidad - VUELTAS_VISIBLES + 1 : 1),
+                  "con %d vueltas guardadas la ventana volvió a cero en %d pasos", anillo.cantidad, pasos);
+    }
+}
+
+// La mejor y la peor se resaltan solo en la ventana que las muestra, y en ninguna cuando salieron del anillo
+static void ProbarResaltadas(void) {
+    static const int DURACIONES[] = {50, 31, 47, 44, 72, 46, 49, 45};
+    int duraciones[VUELTAS_PRUEBA + 20];
+    vista_vueltas vista;
+
+    // La mejor es la 2 y la peor la 5 de 8, la ventana inicial muestra las vueltas 8, 7 y 6
+    TomarVueltas(DURACIONES, sizeof(DURACIONES) / sizeof(DURACIONES[0]));
+    for (int desplazamiento = 0; desplazamiento <= 5; desplazamiento++) {
+        vueltas_vista(&anillo, desplazamiento, &vista);
+        VERIFICAR((vista.mejor == ((desplazamiento >= 4) ? 8 - desplazamiento - 2 : -1)) &&
+                      (vista.peor == ((desplazamiento >= 1) && (desplazamiento <= 3) ? 8 - desplazamiento - 5 : -1)),
+                  "con desplazamiento %d la mejor está en la fila %d y la peor en la %d", desplazamiento, vista.mejor,
+                  vista.peor);
+    }
+
+    // La mejor es la vuelta 10, que ya no está en el anillo, y la peor la 120
+    for (int indice = 0; indice < VUELTAS_PRUEBA; indice++) {
+        duraciones[indice] = (indice == 9) ? 5 : (indice == 119) ? 90 : 20 + indice % 7;
+    }
+    TomarVueltas(duraciones, VUELTAS_PRUEBA);
+    VERIFICAR((anillo.estadisticas.numero_mejor == 10) && (anillo.estadisticas.numero_peor == 120),
+              "la mejor es la vuelta %d y la peor la %d", anillo.estadisticas.numero_mejor,
+              anillo.estadisticas.numero_peor);
+    for (int desplazamiento = 0; desplazamiento + VUELTAS_VISIBLES <= VUELTAS_CAPACIDAD; desplazamiento++) {
+        vueltas_vista(&anillo, desplazamiento, &vista);
+        VERIFICAR(vista.mejor == -1, "con desplazamiento %d la mejor, que salió del anillo, está en la fila %d",
+                  desplazamiento, vista.mejor);
+        VERIFICAR(vista.peor == ((desplazamiento >= 8) && (desplazamiento <= 10) ? 10 - desplazamiento : -1),
+                  "con desplazamiento %d la peor está en la fila %d", desplazamiento, vista.peor);
+    }
+}
+
+// Diferencia relativa entre el valor acumulado y el de referencia
+static double Error(double valor, double referencia) {
+    double error = (valor - referencia) / ((referencia != 0) ? referencia : 1);
+    return (error < 0) ? -error : error;
+}
+
+// Media y varianza de Welford contra las de dos pasadas sobre las mismas duraciones, con el anillo ya lleno
+static void ProbarWelford(void) {
+    int duraciones[VUELTAS_PRUEBA];
+    uint32_t semilla = 12345;
+    double media = 0, varianza = 0;
+
+    for (int indice = 0; indice < VUELTAS_PRUEBA; indice++) {
+        semilla = semilla * 1103515245u + 12345u;
+        duraciones[indice] = 250 + (semilla >> 16) % 50;
+    }
+
+    // Las vueltas suman unos 3600 segundos, así que los parciales cruzan varias veces los 1000 segundos
+    for (int cantidad = 1; cantidad <= VUELTAS_PRUEBA; cantidad++) {
+        TomarVueltas(duraciones, cantidad);
+        media = 0;
+        for (int indice = 0; indice < cantidad; indice++) {
+            media += duraciones[indice];
+        }
+        media /= cantidad;
+        varianza = 0;
+        for (int indice = 0; indice < cantidad; indice++) {
+            varianza += (duraciones[indice] - media) * (duraciones[indice] - media);
+        }
+        varianza = (cantidad > 1) ? varianza / (cantidad - 1) : 0;
+        VERIFICAR((anillo.estadisticas.cantidad == cantidad) &&
+                      (Error(anillo.estadisticas.media, media) < TOLERANCIA) &&
+                      (Error(vueltas_varianza(&anillo.estadisticas), varianza) < TOLERANCIA),
+                  "con %d vueltas la media es %f y la varianza %f, por dos pasadas %f y %f", cantidad,
+                  anillo.estadisticas.media, vueltas_varianza(&anillo.estadisticas), media, varianza);
+    }
+}
+
+// Una vuelta que cruza los 1000 segundos dura lo mismo aunque su parcial sea menor que el anterior
+static void ProbarCruce(void) {
+    vueltas_cero(&anillo);
+    vueltas_agregar(&anillo, Parcial(9950));
+    vueltas_agregar(&anillo, Parcial(30));
+    VERIFICAR((anillo.estadisticas.ultima == 80) && (anillo.estadisticas.mejor == 80) &&
+                  (anillo.estadisticas.numero_mejor == 2),
+              "la vuelta de 995,0 s a 3,0 s dura %d décimas y la mejor es la %d con %d",
+              anillo.estadisticas.ultima, anillo.estadisticas.numero_mejor, anillo.estadisticas.mejor);
+    VERIFICAR(anillo.estadisticas.delta == 80 - 9950, "la diferencia con la vuelta anterior es %d",
+              anillo.estadisticas.delta);
+}
+
+// Con duraciones repetidas la mejor y la peor son las primeras que las alcanzaron
+static void ProbarEmpates(void) {
+    static const int DURACIONES[] = {40, 30, 50, 30, 50, 40};
+    static const int DELTAS[] = {0, -10, 20, -20, 20, -10};
+
+    vueltas_cero(&anillo);
+    parciales[0] = 0;
+    for (size_t indice = 0; indice < sizeof(DURACIONES) / sizeof(DURACIONES[0]); indice++) {
+        parciales[indice + 1] = parciales[indice] + DURACIONES[indice];
+        vueltas_agregar(&anillo, Parcial(parciales[indice + 1]));
+        VERIFICAR(anillo.estadisticas.delta == DELTAS[indice], "la vuelta %d tiene diferencia %d y se esperaba %d",
+                  (int)indice + 1, anillo.estadisticas.delta, DELTAS[indice]);
+    }
+    VERIFICAR((anillo.estadisticas.numero_mejor == 2) && (anillo.estadisticas.mejor == 30) &&
+                  (anillo.estadisticas.numero_peor == 3) && (anillo.estadisticas.peor == 50),
+              "la mejor es la vuelta %d con %d y la peor la %d con %d", anillo.estadisticas.numero_mejor,
+              anillo.estadisticas.mejor, anillo.estadisticas.numero_peor, anillo.estadisticas.peor);
+}
+
+/* === Public function implementation ============================================================================== */
+
+int main(void) {
+    ProbarAnillo();
+    ProbarPocas();
+    ProbarDesplazar();
+    ProbarResaltadas();
+    ProbarWelford();
+    ProbarCruce();
+    ProbarEmpates();
+    return RESULTADO();
+}
+
+/* === End of documentation ======================================================================================== */
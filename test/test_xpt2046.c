@@ -0,0 +1,162 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+
+/** @file test_xpt2046.c
+ ** @brief Prueba del driver del controlador táctil XPT2046 con un controlador simulado
+ **
+ ** El driver se compila sin ESP_PLATFORM y recibe la función de intercambio del controlador simulado. La prueba cubre
+ ** el filtro de mediana de cada lote, el umbral de presión y la conversión de las lecturas a pixeles de la pantalla.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "tactil_falso.h"
+#include "prueba.h"
+#include "ili9341.h"
+
+/* === Macros definitions ========================================================================================== */
+
+#define CENTRO_X ((XPT2046_RAW_X_MIN + XPT2046_RAW_X_MAX) / 2) //!< Lectura del centro de la pantalla en X
+#define CENTRO_Y ((XPT2046_RAW_Y_MIN + XPT2046_RAW_Y_MAX) / 2) //!< Lectura del centro de la pantalla en Y
+#define PRESION  (XPT2046_Z_THRESHOLD * 4)                     //!< Presión de un toque firme
+
+/* === Private data type declarations ============================================================================== */
+
+/* === Private variable declarations =============================================================================== */
+
+/* === Private function declarations =============================================================================== */
+
+/* === Public variable definitions ================================================================================= */
+
+int fallas;
+
+/* === Private variable definitions ================================================================================ */
+
+/* === Private function definitions ================================================================================ */
+
+// Lee un lote con las muestras dadas y verifica que el driver hizo un único intercambio bien formado
+static bool Leer(const uint16_t * z, const uint16_t * x, const uint16_t * y, xpt2046_point_t * punto) {
+    uint32_t lotes = TactilFalsoLotes();
+    bool tocado;
+
+    TactilFalsoTocar(z, x, y);
+    tocado = XPT2046Read(punto);
+    VERIFICAR(TactilFalsoLotes() == lotes + 1, "la lectura hizo %u intercambios", TactilFalsoLotes() - lotes);
+    return tocado;
+}
+
+// Lee un lote con todas las muestras iguales
+static bool LeerFijo(uint16_t z, uint16_t x, uint16_t y, xpt2046_point_t * punto) {
+    uint16_t muestras_z[XPT2046_SAMPLES], muestras_x[XPT2046_SAMPLES], muestras_y[XPT2046_SAMPLES];
+
+    for (int indice = 0; indice < XPT2046_SAMPLES; indice++) {
+        muestras_z[indice] = z;
+        muestras_x[indice] = x;
+        muestras_y[indice] = y;
+    }
+    return Leer(muestras_z, muestras_x, muestras_y, punto);
+}
+
+static void ProbarSinIniciar(void) {
+    xpt2046_point_t punto;
+
+    VERIFICAR(!XPT2046Read(&punto), "el driver sin iniciar informó un toque");
+    VERIFICAR(TactilFalsoLotes() == 0, "el driver sin iniciar usó el bus");
+}
+
+// Hasta dos muestras por canal pueden estar fuera de lugar sin mover el punto, en cualquier orden
+static void ProbarMediana(void) {
+    const uint16_t presion[] = {PRESION, 0, PRESION, 4095, PRESION};
+    const uint16_t x[] = {4095, CENTRO_X - 5, 0, CENTRO_X + 5, CENTRO_X};
+    const uint16_t y[] = {4095, CENTRO_Y, 0, CENTRO_Y, CENTRO_Y};
+    xpt2046_point_t esperado, punto;
+
+    VERIFICAR(LeerFijo(PRESION, CENTRO_X, CENTRO_Y, &esperado), "un toque firme no se informó");
+    VERIFICAR(Leer(presion, x, y, &punto), "un toque con muestras fuera de lugar no se informó");
+    VERIFICAR(punto.z == PRESION, "la presión es %u y se esperaba la mediana %u", punto.z, PRESION);
+    VERIFICAR((punto.x == esperado.x) && (punto.y == esperado.y),
+              "el punto con muestras fuera de lugar es %u,%u y se esperaba %u,%u", punto.x, punto.y, esperado.x,
+              esperado.y);
+}
+
+// La presión de la mediana decide el toque, una muestra aislada no alcanza para informarlo ni para perderlo
+static void ProbarUmbral(void) {
+    const uint16_t pico[] = {4095, 0, 0, 0, 0};
+    const uint16_t pocas[] = {0, PRESION, 0, PRESION, 0};
+    const uint16_t mayoria[] = {PRESION, 0, PRESION, 0, PRESION};
+    const uint16_t centro_x[] = {CENTRO_X, CENTRO_X, CENTRO_X, CENTRO_X, CENTRO_X};
+    const uint16_t centro_y[] = {CENTRO_Y, CENTRO_Y, CENTRO_Y, CENTRO_Y, CENTRO_Y};
+    xpt2046_point_t punto;
+
+    VERIFICAR(LeerFijo(XPT2046_Z_THRESHOLD, CENTRO_X, CENTRO_Y, &punto), "la presión del umbral no se informó");
+    VERIFICAR(!LeerFijo(XPT2046_Z_THRESHOLD - 1, CENTRO_X, CENTRO_Y, &punto), "una presión bajo el umbral se informó");
+    VERIFICAR(punto.z == XPT2046_Z_THRESHOLD - 1, "sin toque la presión es %u y se esperaba %u", punto.z,
+              XPT2046_Z_THRESHOLD - 1);
+    VERIFICAR(!LeerFijo(0, 0, 0, &punto), "el panel sin tocar se informó como tocado");
+    VERIFICAR(!Leer(pico, centro_x, centro_y, &punto), "un pico aislado de presión se informó");
+    VERIFICAR(!Leer(pocas, centro_x, centro_y, &punto), "dos muestras de cinco con presión se informaron");
+    VERIFICAR(Leer(mayoria, centro_x, centro_y, &punto), "tres muestras de cinco con presión no se informaron");
+}
+
+// Los extremos de la calibración van a los bordes de la pantalla, las lecturas fuera de ellos se recortan
+static void ProbarEscala(void) {
+    xpt2046_point_t punto, anterior = {0};
+
+    LeerFijo(PRESION, XPT2046_RAW_X_MIN, XPT2046_RAW_Y_MIN, &punto);
+    VERIFICAR((punto.x == 0) && (punto.y == 0), "el mínimo de la calibración es %u,%u", punto.x, punto.y);
+    LeerFijo(PRESION, XPT2046_RAW_X_MAX, XPT2046_RAW_Y_MAX, &punto);
+    VERIFICAR((punto.x == ILI9341_WIDTH - 1) && (punto.y == ILI9341_HEIGHT - 1), "el máximo de la calibración es %u,%u",
+              punto.x, punto.y);
+    LeerFijo(PRESION, 0, 0, &punto);
+    VERIFICAR((punto.x == 0) && (punto.y == 0), "las lecturas bajo la calibración son %u,%u", punto.x, punto.y);
+    LeerFijo(PRESION, 4095, 4095, &punto);
+    VERIFICAR((punto.x == ILI9341_WIDTH - 1) && (punto.y == ILI9341_HEIGHT - 1),
+              "las lecturas sobre la calibración son %u,%u", punto.x, punto.y);
+    LeerFijo(PRESION, CENTRO_X, CENTRO_Y, &punto);
+    VERIFICAR((punto.x + 1 >= (ILI9341_WIDTH - 1) / 2) && (punto.x <= ILI9341_WIDTH / 2) &&
+                  (punto.y + 1 >= (ILI9341_HEIGHT - 1) / 2) && (punto.y <= ILI9341_HEIGHT / 2),
+              "el centro de la calibración es %u,%u", punto.x, punto.y);
+
+    // Cada lectura de 12 bits da un pixel que no retrocede
+    for (uint16_t lectura = 0; lectura <= 0x0FFF; lectura++) {
+        LeerFijo(PRESION, lectura, lectura, &punto);
+        if ((punto.x < anterior.x) || (punto.y < anterior.y) || (punto.x >= ILI9341_WIDTH) ||
+            (punto.y >= ILI9341_HEIGHT)) {
+            VERIFICAR(false, "la lectura %u da el pixel %u,%u después de %u,%u", lectura, punto.x, punto.y, anterior.x,
+                      anterior.y);
+            break;
+        }
+        anterior = punto;
+    }
+}
+
+/* === Public function implementation ============================================================================== */
+
+int main(void) {
+    ProbarSinIniciar();
+    XPT2046Init(TactilFalsoTransferir);
+    ProbarMediana();
+    ProbarUmbral();
+    ProbarEscala();
+    VERIFICAR(TactilFalsoErrores() == 0, "el controlador no pudo interpretar %u intercambios", TactilFalsoErrores());
+    return RESULTADO();
+}
+
+/* === End of documentation ======================================================================================== */